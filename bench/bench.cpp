@@ -0,0 +1,367 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// cpuminer-bench: times each stage of the RandomQ mining path in isolation
+// and prints ns/hash, cycles/hash and their standard deviation as JSON.
+//
+// Usage: cpuminer-bench [--samples N] [--sample-ms N] [--rounds R1,R2,...] [--stage NAME]
+
+#include "cpu_info.h"
+#include "randomq_hash.h"
+#include "randomq_kernel.h"
+#include "randomq_mining.h"
+#include "randomq_target.h"
+#include "sha256.h"
+#include "sha256_lanes.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+namespace {
+
+struct BenchSettings {
+    int samples = 10;
+    int sample_ms = 100;
+    std::vector<uint64_t> rounds = {1, 64, 1024, 8192};
+    std::string stage; // Only run stages whose name contains this
+};
+
+struct BenchResult {
+    std::string stage;
+    std::string kernel;  // Empty when the stage does not depend on the kernel
+    uint64_t rounds = 0; // 0 when the stage does not depend on the round count
+    uint64_t iterations = 0;
+    double ns_mean = 0.0;
+    double ns_stddev = 0.0;
+    double cycles_mean = 0.0;
+    double cycles_stddev = 0.0;
+};
+
+// Keep the compiler from discarding benchmarked work
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+uint64_t ReadCycles() {
+#if defined(BENCH_HAVE_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+void MeanStddev(const std::vector<double>& values, double& mean, double& stddev) {
+    mean = 0.0;
+    for (double v : values) {
+        mean += v;
+    }
+    mean /= values.size();
+    
+    double variance = 0.0;
+    for (double v : values) {
+        variance += (v - mean) * (v - mean);
+    }
+    stddev = values.size() > 1 ? std::sqrt(variance / (values.size() - 1)) : 0.0;
+}
+
+class Bench {
+public:
+    explicit Bench(const BenchSettings& settings) : m_settings(settings) {}
+    
+    // Time fn(), which performs hashes_per_call units of work per call
+    template <typename Fn>
+    void Run(const std::string& stage, const std::string& kernel, uint64_t rounds, uint64_t hashes_per_call, Fn fn) {
+        if (!m_settings.stage.empty() && stage.find(m_settings.stage) == std::string::npos) {
+            return;
+        }
+        
+        // Calibrate the calls per sample so one sample takes about sample_ms
+        const auto sample_time = std::chrono::milliseconds(m_settings.sample_ms);
+        uint64_t calls = 1;
+        while (true) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < calls; i++) {
+                fn();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed >= sample_time / 4 || calls >= (1ULL << 40)) {
+                double scale = std::chrono::duration<double>(sample_time) / std::chrono::duration<double>(elapsed);
+                calls = std::max<uint64_t>(1, static_cast<uint64_t>(calls * scale));
+                break;
+            }
+            calls *= 2;
+        }
+        
+        std::vector<double> ns_per_hash;
+        std::vector<double> cycles_per_hash;
+        for (int sample = 0; sample < m_settings.samples; sample++) {
+            uint64_t cycles_start = ReadCycles();
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < calls; i++) {
+                fn();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            uint64_t cycles = ReadCycles() - cycles_start;
+            
+            double hashes = static_cast<double>(calls * hashes_per_call);
+            ns_per_hash.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / hashes);
+            cycles_per_hash.push_back(cycles / hashes);
+        }
+        
+        BenchResult result;
+        result.stage = stage;
+        result.kernel = kernel;
+        result.rounds = rounds;
+        result.iterations = calls * hashes_per_call * m_settings.samples;
+        MeanStddev(ns_per_hash, result.ns_mean, result.ns_stddev);
+        MeanStddev(cycles_per_hash, result.cycles_mean, result.cycles_stddev);
+        m_results.push_back(result);
+        
+        std::cerr << stage << (kernel.empty() ? "" : " " + kernel)
+                  << (rounds ? " rounds=" + std::to_string(rounds) : "") << ": "
+                  << std::fixed << std::setprecision(1) << result.ns_mean << " ns/hash" << std::endl;
+    }
+    
+    void PrintJson(std::ostream& out) const {
+        out << std::fixed << std::setprecision(3);
+        out << "{\n";
+        out << "  \"cpu_features\": \"" << CPUInfo::FeatureString() << "\",\n";
+        out << "  \"sha256_implementation\": \"" << RandomQKernel::Sha256Implementation() << "\",\n";
+        out << "  \"sha256_lanes\": \"" << Sha256Lanes::Implementation() << "\",\n";
+        out << "  \"cycle_counter\": " << (HaveCycleCounter() ? "\"tsc\"" : "null") << ",\n";
+        out << "  \"samples\": " << m_settings.samples << ",\n";
+        out << "  \"sample_ms\": " << m_settings.sample_ms << ",\n";
+        out << "  \"results\": [";
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const BenchResult& r = m_results[i];
+            out << (i ? ",\n" : "\n");
+            out << "    {\"stage\": \"" << r.stage << "\"";
+            out << ", \"kernel\": ";
+            if (r.kernel.empty()) {
+                out << "null";
+            } else {
+                out << "\"" << r.kernel << "\"";
+            }
+            out << ", \"rounds\": ";
+            if (r.rounds) {
+                out << r.rounds;
+            } else {
+                out << "null";
+            }
+            out << ", \"iterations\": " << r.iterations;
+            out << ", \"ns_per_hash\": " << r.ns_mean << ", \"ns_stddev\": " << r.ns_stddev;
+            if (HaveCycleCounter()) {
+                out << ", \"cycles_per_hash\": " << r.cycles_mean << ", \"cycles_stddev\": " << r.cycles_stddev;
+            } else {
+                out << ", \"cycles_per_hash\": null, \"cycles_stddev\": null";
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static bool HaveCycleCounter() {
+#if defined(BENCH_HAVE_TSC)
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    BenchSettings m_settings;
+    std::vector<BenchResult> m_results;
+};
+
+bool ParseRounds(const std::string& list, std::vector<uint64_t>& rounds) {
+    rounds.clear();
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        char* end = nullptr;
+        uint64_t value = std::strtoull(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value == 0) {
+            return false;
+        }
+        rounds.push_back(value);
+    }
+    return !rounds.empty();
+}
+
+bool ParseArgs(int argc, char* argv[], BenchSettings& settings) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            settings.samples = std::atoi(argv[++i]);
+        } else if (arg == "--sample-ms" && i + 1 < argc) {
+            settings.sample_ms = std::atoi(argv[++i]);
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            if (!ParseRounds(argv[++i], settings.rounds)) {
+                return false;
+            }
+        } else if (arg == "--stage" && i + 1 < argc) {
+            settings.stage = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return settings.samples > 0 && settings.sample_ms > 0;
+}
+
+CBlockHeader BenchHeader() {
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256("0x0000000000000000000a1b2c3d4e5f60718293a4b5c6d7e8f90123456789abcd");
+    header.hashMerkleRoot = uint256("0x4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    header.nTime = 1700000000;
+    header.nBits = 0x1d00ffff;
+    header.nNonce = 0;
+    return header;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+    if (!ParseArgs(argc, argv, settings)) {
+        std::cerr << "Usage: " << argv[0] << " [--samples N] [--sample-ms N] [--rounds R1,R2,...] [--stage NAME]" << std::endl;
+        return 1;
+    }
+    
+    // Installs the SHA256 transform; the kernel is forced per stage below
+    RandomQKernel::Select(true, true);
+    
+    Bench bench(settings);
+    CBlockHeader header = BenchHeader();
+    HeaderBytes header_data;
+    uint32_t nonce = 0;
+    
+    // Header serialization, once per nonce in the unoptimized path
+    bench.Run("serialize_header", "", 0, 1, [&] {
+        header.nNonce = nonce++;
+        RandomQMining::SerializeHeader(header, header_data);
+        DoNotOptimize(header_data);
+    });
+    
+    // Prefix absorb, once per job with the midstate path
+    CRandomQHash prefix_hasher;
+    bench.Run("prefix_absorb", "", 0, 1, [&] {
+        RandomQMining::PrepareMidstate(prefix_hasher, header);
+        DoNotOptimize(prefix_hasher);
+    });
+    
+    // SHA256 stages: the 80-byte header input and the 32-byte digest output
+    unsigned char digest[CSHA256::OUTPUT_SIZE];
+    bench.Run("sha256_80", "", 0, 1, [&] {
+        CSHA256().Write(header_data.data(), header_data.size()).Finalize(digest);
+        DoNotOptimize(digest);
+    });
+    bench.Run("sha256_32", "", 0, 1, [&] {
+        CSHA256().Write(digest, sizeof(digest)).Finalize(digest);
+        DoNotOptimize(digest);
+    });
+    
+    unsigned char lane_inputs[Sha256Lanes::MAX_LANES][CSHA256::OUTPUT_SIZE] = {};
+    const unsigned char* lane_ptrs[Sha256Lanes::MAX_LANES];
+    for (size_t i = 0; i < Sha256Lanes::MAX_LANES; i++) {
+        lane_inputs[i][0] = static_cast<unsigned char>(i);
+        lane_ptrs[i] = lane_inputs[i];
+    }
+    unsigned char lane_out[Sha256Lanes::MAX_LANES][Sha256Lanes::OUTPUT_SIZE];
+    bench.Run("sha256_lanes_32", Sha256Lanes::Implementation(), 0, Sha256Lanes::MAX_LANES, [&] {
+        Sha256Lanes::Hash(lane_ptrs, CSHA256::OUTPUT_SIZE, lane_out, Sha256Lanes::MAX_LANES);
+        DoNotOptimize(lane_out);
+    });
+    
+    // Full 256-bit target compare on a hash that passes the top word
+    CompiledTarget target;
+    CompiledTarget::FromCompact(header.nBits, target);
+    uint256 near_hash;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 8; j++) {
+            near_hash.begin()[8 * i + j] = static_cast<unsigned char>(target.words[i] >> (8 * j));
+        }
+    }
+    bench.Run("target_check", "", 0, 1, [&] {
+        bool below = target.Check(near_hash);
+        DoNotOptimize(below);
+    });
+    
+    // Reference path: absorb and finalize the whole 80-byte header at each round count
+    for (uint64_t rounds : settings.rounds) {
+        CRandomQHash hasher;
+        hasher.SetRandomQRounds(rounds);
+        bench.Run("full_header", "", rounds, 1, [&] {
+            header.nNonce = nonce++;
+            RandomQMining::SerializeHeader(header, header_data);
+            uint256 hash = RandomQMining::CalculateRandomQHash(hasher, header_data);
+            DoNotOptimize(hash);
+        });
+    }
+    
+    // Per kernel: lane filter, then the round loop from the midstate at each round count
+    const RandomQKernel::Kernel& active = RandomQKernel::Active();
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        
+        uint256 hashes[RandomQKernel::MAX_LANES];
+        for (size_t i = 0; i < kernel.lanes; i++) {
+            hashes[i] = near_hash;
+        }
+        bench.Run("filter_lanes", kernel.name, 0, kernel.lanes, [&] {
+            uint32_t mask = kernel.filter_lanes(hashes, kernel.lanes, target.words[3]);
+            DoNotOptimize(mask);
+        });
+        
+        for (uint64_t rounds : settings.rounds) {
+            CRandomQHash midstate;
+            midstate.SetRandomQRounds(rounds);
+            RandomQMining::PrepareMidstate(midstate, header);
+            
+            uint32_t nonces[RandomQKernel::MAX_LANES];
+            bench.Run("hash_lanes", kernel.name, rounds, kernel.lanes, [&] {
+                for (size_t i = 0; i < kernel.lanes; i++) {
+                    nonces[i] = nonce++;
+                }
+                kernel.hash_lanes(midstate, nonces, hashes, kernel.lanes);
+                DoNotOptimize(hashes);
+            });
+            
+            // The whole mining loop body: hash, filter and compare
+            RandomQMining::HashJob job;
+            RandomQMining::PrepareJob(job, header, rounds);
+            RandomQKernel::Activate(kernel);
+            bench.Run("hash_range", kernel.name, rounds, 64, [&] {
+                uint64_t done = RandomQMining::HashRange(job, nonce, 64, target, [](uint32_t, const uint256&) {
+                    return true;
+                });
+                nonce += 64;
+                DoNotOptimize(done);
+            });
+        }
+    }
+    RandomQKernel::Activate(active);
+    
+    bench.PrintJson(std::cout);
+    return 0;
+}
@@ -3,11 +3,15 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "config.h"
+#include "cpu_info.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <thread>
+#include <unistd.h>
 
 MinerConfig::MinerConfig() {
     // Set default values
@@ -37,17 +41,38 @@ bool MinerConfig::validate() const {
         return false;
     }
     
+    if (nonce_batch == 0) {
+        std::cerr << "Error: Nonce batch must be greater than 0" << std::endl;
+        return false;
+    }
+    
     // Validate logging settings
     if (log_level < 0 || log_level > 3) {
         std::cerr << "Error: Invalid log level: " << log_level << std::endl;
         return false;
     }
     
+    if (ntime_roll > 7200) {
+        std::cerr << "Error: nTime roll must not exceed 7200 seconds" << std::endl;
+        return false;
+    }
+    
+    std::vector<unsigned int> cpus;
+    if (!CPUInfo::PlanAffinity(affinity, 1, cpus)) {
+        std::cerr << "Error: Invalid affinity " << affinity << ": use none, cores, smt or a list of allowed CPUs" << std::endl;
+        return false;
+    }
+    
     if (stats_interval == 0) {
         std::cerr << "Error: Stats interval must be greater than 0" << std::endl;
         return false;
     }
     
+    if ((benchmark || autotune) && benchmark_duration == 0) {
+        std::cerr << "Error: Benchmark duration must be greater than 0" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
@@ -63,9 +88,25 @@ void MinerConfig::print() const {
     std::cout << "SSE4: " << (enable_sse4 ? "enabled" : "disabled") << std::endl;
     std::cout << "Optimized: " << (enable_optimized ? "enabled" : "disabled") << std::endl;
     std::cout << "Submit Work: " << (submit_work ? "enabled" : "disabled") << std::endl;
+    std::cout << "Kernel: " << kernel << std::endl;
+    std::cout << "Nonce Batch: " << nonce_batch << std::endl;
+    std::cout << "SMT: " << (use_smt ? "enabled" : "disabled") << std::endl;
+    std::cout << "Version Mask: 0x" << std::hex << version_mask << std::dec << std::endl;
+    std::cout << "nTime Roll: " << ntime_roll << " seconds" << std::endl;
+    std::cout << "Affinity: " << affinity << std::endl;
+    std::cout << "Verify Sample: " << (verify_sample > 0 ? "1 in " + std::to_string(verify_sample) + " hashes" : "disabled") << std::endl;
+    if (!control_socket.empty()) {
+        std::cout << "Control Socket: " << control_socket << std::endl;
+    }
     std::cout << "Log Level: " << log_level << std::endl;
     std::cout << "Show Stats: " << (show_stats ? "enabled" : "disabled") << std::endl;
     std::cout << "Stats Interval: " << stats_interval << " seconds" << std::endl;
+    if (benchmark) {
+        std::cout << "Benchmark: " << benchmark_duration << " seconds per thread count" << std::endl;
+    }
+    if (autotune) {
+        std::cout << "Autotune: " << benchmark_duration << " seconds per trial, saving to " << autotune_file << std::endl;
+    }
     std::cout << "=========================" << std::endl;
 }
 
@@ -82,9 +123,19 @@ bool ConfigManager::loadFromArgs(int argc, char* argv[], MinerConfig& config) {
             return false;
         }
         
+        // Accept both "--key=value" and "--key value"
         if (!parseArg(arg, config)) {
-            std::cerr << "Error: Invalid argument: " << arg << std::endl;
-            return false;
+            bool parsed = false;
+            if (arg.find('=') == std::string::npos && i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                parsed = parseArg(arg + "=" + argv[i + 1], config);
+                if (parsed) {
+                    i++;
+                }
+            }
+            if (!parsed) {
+                std::cerr << "Error: Invalid argument: " << arg << std::endl;
+                return false;
+            }
         }
     }
     
@@ -141,12 +192,30 @@ bool ConfigManager::loadFromFile(const std::string& filename, MinerConfig& confi
             config.enable_optimized = (value == "true" || value == "1");
         } else if (key == "submit_work") {
             config.submit_work = (value == "true" || value == "1");
+        } else if (key == "kernel") {
+            config.kernel = value;
+        } else if (key == "nonce_batch") {
+            config.nonce_batch = std::stoul(value);
+        } else if (key == "use_smt") {
+            config.use_smt = (value == "true" || value == "1");
+        } else if (key == "verify_sample") {
+            config.verify_sample = std::stoull(value);
+        } else if (key == "version_mask") {
+            config.version_mask = std::stoul(value, nullptr, 16);
+        } else if (key == "ntime_roll") {
+            config.ntime_roll = std::stoul(value);
+        } else if (key == "affinity") {
+            config.affinity = value;
         } else if (key == "log_level") {
             config.log_level = std::stoi(value);
         } else if (key == "show_stats") {
             config.show_stats = (value == "true" || value == "1");
         } else if (key == "stats_interval") {
             config.stats_interval = std::stoi(value);
+        } else if (key == "tuning_cache") {
+            config.tuning_cache = value;
+        } else if (key == "control_socket") {
+            config.control_socket = value;
         }
     }
     
@@ -178,6 +247,13 @@ bool ConfigManager::saveToFile(const std::string& filename, const MinerConfig& c
     file << "enable_sse4=" << (config.enable_sse4 ? "true" : "false") << std::endl;
     file << "enable_optimized=" << (config.enable_optimized ? "true" : "false") << std::endl;
     file << "submit_work=" << (config.submit_work ? "true" : "false") << std::endl;
+    file << "kernel=" << config.kernel << std::endl;
+    file << "nonce_batch=" << config.nonce_batch << std::endl;
+    file << "use_smt=" << (config.use_smt ? "true" : "false") << std::endl;
+    file << "verify_sample=" << config.verify_sample << std::endl;
+    file << "version_mask=" << std::hex << config.version_mask << std::dec << std::endl;
+    file << "ntime_roll=" << config.ntime_roll << std::endl;
+    file << "affinity=" << config.affinity << std::endl;
     file << std::endl;
     
     file << "# Logging settings" << std::endl;
@@ -185,6 +261,122 @@ bool ConfigManager::saveToFile(const std::string& filename, const MinerConfig& c
     file << "show_stats=" << (config.show_stats ? "true" : "false") << std::endl;
     file << "stats_interval=" << config.stats_interval << std::endl;
     
+    if (!config.tuning_cache.empty()) {
+        file << std::endl;
+        file << "# Tuning cache" << std::endl;
+        file << "tuning_cache=" << config.tuning_cache << std::endl;
+    }
+    
+    if (!config.control_socket.empty()) {
+        file << std::endl;
+        file << "# Runtime control" << std::endl;
+        file << "control_socket=" << config.control_socket << std::endl;
+    }
+    
+    return true;
+}
+
+bool ConfigManager::loadTuning(const std::string& filename, const std::string& fingerprint, MinerConfig& config) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // Entries are "[fingerprint]" sections of key=value lines
+    MinerConfig tuned = config;
+    bool in_entry = false;
+    bool found = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line[0] == '[') {
+            in_entry = line.size() >= 2 && line.back() == ']' && line.substr(1, line.size() - 2) == fingerprint;
+            found |= in_entry;
+            continue;
+        }
+        if (!in_entry) {
+            continue;
+        }
+        
+        size_t pos = line.find('=');
+        if (pos == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, pos);
+        std::string value = line.substr(pos + 1);
+        
+        if (key == "num_threads") {
+            tuned.num_threads = std::stoi(value);
+        } else if (key == "kernel") {
+            tuned.kernel = value;
+        } else if (key == "nonce_batch") {
+            tuned.nonce_batch = std::stoul(value);
+        } else if (key == "use_smt") {
+            tuned.use_smt = (value == "true" || value == "1");
+        } else if (key == "affinity") {
+            tuned.affinity = value;
+        }
+    }
+    
+    std::vector<unsigned int> cpus;
+    if (!found || tuned.num_threads <= 0 || tuned.nonce_batch == 0 ||
+        !CPUInfo::PlanAffinity(tuned.affinity, 1, cpus)) {
+        return false;
+    }
+    config = tuned;
+    return true;
+}
+
+bool ConfigManager::saveTuning(const std::string& filename, const std::string& fingerprint, const MinerConfig& config) {
+    // Keep the entries for other hardware, dropping any old one for this fingerprint
+    std::vector<std::string> kept;
+    {
+        std::ifstream existing(filename);
+        std::string line;
+        bool skipping = false;
+        while (std::getline(existing, line)) {
+            if (!line.empty() && line[0] == '[') {
+                skipping = line == "[" + fingerprint + "]";
+            }
+            if (!skipping && !(line.empty() || line[0] == '#')) {
+                kept.push_back(line);
+            }
+        }
+    }
+    
+    // Write a private temporary file and rename it over the cache, so a crash
+    // or a second miner never sees the cache half written
+    const std::string temp_name = filename + ".tmp." + std::to_string(::getpid());
+    std::ofstream file(temp_name, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write tuning cache: " << temp_name << std::endl;
+        return false;
+    }
+    
+    file << "# Bitquantum RandomQ CPU Miner tuning cache" << std::endl;
+    file << "# One [CPU model; microcode; features; cores; rounds] entry per host type" << std::endl;
+    for (const std::string& line : kept) {
+        if (line[0] == '[') {
+            file << std::endl;
+        }
+        file << line << std::endl;
+    }
+    file << std::endl;
+    file << "[" << fingerprint << "]" << std::endl;
+    file << "num_threads=" << config.num_threads << std::endl;
+    file << "kernel=" << config.kernel << std::endl;
+    file << "nonce_batch=" << config.nonce_batch << std::endl;
+    file << "use_smt=" << (config.use_smt ? "true" : "false") << std::endl;
+    file << "affinity=" << config.affinity << std::endl;
+    
+    file.close();
+    if (!file || std::rename(temp_name.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Error: Cannot write tuning cache: " << filename << std::endl;
+        std::remove(temp_name.c_str());
+        return false;
+    }
     return true;
 }
 
@@ -197,21 +389,36 @@ void ConfigManager::printHelp() {
     std::cout << "  --rpc-port <port>        RPC server port (default: 8332)" << std::endl;
     std::cout << "  --rpc-user <user>        RPC username" << std::endl;
     std::cout << "  --rpc-password <pass>    RPC password" << std::endl;
-    std::cout << "  --threads <count>        Number of mining threads (default: auto)" << std::endl;
+    std::cout << "  --threads <count>        Number of mining threads (default: usable CPUs)" << std::endl;
     std::cout << "  --randomq-rounds <num>   RandomQ rounds (default: 8192)" << std::endl;
     std::cout << "  --enable-avx2            Enable AVX2 optimizations" << std::endl;
     std::cout << "  --enable-sse4            Enable SSE4 optimizations" << std::endl;
     std::cout << "  --enable-optimized       Enable optimized algorithms" << std::endl;
     std::cout << "  --no-submit              Don't submit work to pool" << std::endl;
+    std::cout << "  --kernel <name>          Hashing kernel: auto or generic (default: auto)" << std::endl;
+    std::cout << "  --nonce-batch <num>      Nonces per hashing call and first nonce lease (default: 256)" << std::endl;
+    std::cout << "  --no-smt                 Use at most one thread per physical core" << std::endl;
+    std::cout << "  --version-mask <hex>     Version bits rolled when a nonce range runs out, 0 disables (default: 1fffe000)" << std::endl;
+    std::cout << "  --ntime-roll <sec>       Seconds nTime may be rolled past the clock, at most 7200 (default: 600)" << std::endl;
+    std::cout << "  --affinity <policy>      Pin threads: none, cores, smt or a CPU list like 0,2,4-7 (default: cores)" << std::endl;
+    std::cout << "  --verify-sample <num>    Re-check 1 in num hashes on the reference path, 0 disables (default: 100000)" << std::endl;
     std::cout << "  --log-level <level>      Log level 0-3 (default: 2)" << std::endl;
     std::cout << "  --no-stats               Don't show statistics" << std::endl;
     std::cout << "  --stats-interval <sec>   Statistics update interval (default: 10)" << std::endl;
-    std::cout << "  --config <file>          Load configuration from file" << std::endl;
+    std::cout << "  --config <file>          Load configuration from file; SIGHUP re-reads it" << std::endl;
+    std::cout << "  --control-socket <path>  Accept control commands (threads [N], reload, stats) on a UNIX socket" << std::endl;
+    std::cout << "  --benchmark              Hash generated work offline and report thread scaling" << std::endl;
+    std::cout << "  --duration <sec>         Seconds per benchmark step or autotune trial (default: 5)" << std::endl;
+    std::cout << "  --autotune               Search threads, kernel, nonce batch and SMT, then save the best" << std::endl;
+    std::cout << "  --autotune-file <file>   Where --autotune saves the configuration (default: config.tuned.conf)" << std::endl;
+    std::cout << "  --tuning-cache <file>    Reuse tuning for this hardware, autotuning only when it changes" << std::endl;
     std::cout << "  --help, -h               Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  cpuminer --rpc-host localhost --rpc-port 8332 --threads 4" << std::endl;
     std::cout << "  cpuminer --config miner.conf" << std::endl;
+    std::cout << "  cpuminer --benchmark --duration 10" << std::endl;
+    std::cout << "  cpuminer --autotune --duration 3 --autotune-file miner.conf" << std::endl;
 }
 
 bool ConfigManager::parseArg(const std::string& arg, MinerConfig& config) {
@@ -254,6 +461,26 @@ bool ConfigManager::parseArg(const std::string& arg, MinerConfig& config) {
         config.enable_optimized = true;
     } else if (key == "no-submit") {
         config.submit_work = false;
+    } else if (key == "kernel") {
+        if (value.empty()) return false;
+        config.kernel = value;
+    } else if (key == "nonce-batch") {
+        if (value.empty()) return false;
+        config.nonce_batch = std::stoul(value);
+    } else if (key == "no-smt") {
+        config.use_smt = false;
+    } else if (key == "version-mask") {
+        if (value.empty()) return false;
+        config.version_mask = std::stoul(value, nullptr, 16);
+    } else if (key == "ntime-roll") {
+        if (value.empty()) return false;
+        config.ntime_roll = std::stoul(value);
+    } else if (key == "affinity") {
+        if (value.empty()) return false;
+        config.affinity = value;
+    } else if (key == "verify-sample") {
+        if (value.empty()) return false;
+        config.verify_sample = std::stoull(value);
     } else if (key == "log-level") {
         if (value.empty()) return false;
         config.log_level = std::stoi(value);
@@ -262,8 +489,25 @@ bool ConfigManager::parseArg(const std::string& arg, MinerConfig& config) {
     } else if (key == "stats-interval") {
         if (value.empty()) return false;
         config.stats_interval = std::stoi(value);
+    } else if (key == "benchmark") {
+        config.benchmark = true;
+    } else if (key == "duration") {
+        if (value.empty()) return false;
+        config.benchmark_duration = std::stoul(value);
+    } else if (key == "autotune") {
+        config.autotune = true;
+    } else if (key == "autotune-file") {
+        if (value.empty()) return false;
+        config.autotune_file = value;
+    } else if (key == "tuning-cache") {
+        if (value.empty()) return false;
+        config.tuning_cache = value;
+    } else if (key == "control-socket") {
+        if (value.empty()) return false;
+        config.control_socket = value;
     } else if (key == "config") {
         if (value.empty()) return false;
+        config.config_file = value;
         return loadFromFile(value, config);
     } else {
         return false;
@@ -280,15 +524,34 @@ void ConfigManager::setDefaults(MinerConfig& config) {
     config.rpc_password = "";
     
     // Mining settings
-    config.num_threads = std::thread::hardware_concurrency();
+    // Allowed CPUs within the cgroup quota, not every CPU on the host
+    config.num_threads = CPUInfo::UsableCpuCount();
     config.randomq_rounds = 8192;
     config.enable_avx2 = true;
     config.enable_sse4 = true;
     config.enable_optimized = true;
     config.submit_work = true;
+    config.kernel = "auto";
+    config.nonce_batch = 256;
+    config.use_smt = true;
+    config.verify_sample = 100000;
+    config.version_mask = 0x1fffe000;
+    config.ntime_roll = 600;
+    config.affinity = "cores";
+    
+    // Runtime control
+    config.config_file = "";
+    config.control_socket = "";
     
     // Logging settings
     config.log_level = 2;
     config.show_stats = true;
     config.stats_interval = 10;
+    
+    // Benchmark and autotune settings
+    config.benchmark = false;
+    config.benchmark_duration = 5;
+    config.autotune = false;
+    config.autotune_file = "config.tuned.conf";
+    config.tuning_cache = "";
 }
\ No newline at end of file
@@ -24,12 +24,30 @@ struct MinerConfig {
     bool enable_sse4;
     bool enable_optimized;
     bool submit_work;
+    std::string kernel;     // Hashing kernel name, or "auto" to pick at startup
+    uint32_t nonce_batch;   // Nonces per hashing call and first lease size
+    bool use_smt;           // Run more threads than physical cores
+    uint64_t verify_sample; // Re-check 1 in this many hashes on the reference path; 0 disables
+    uint32_t version_mask;  // Version bits rolled when a nonce range runs out (BIP320)
+    uint32_t ntime_roll;    // Seconds nTime may be rolled past the wall clock
+    std::string affinity;   // Thread pinning: "none", "cores", "smt" or a CPU list like "0,2,4-7"
+    
+    // Runtime control
+    std::string config_file;    // File given with --config, re-read on SIGHUP
+    std::string control_socket; // UNIX socket for control commands; empty disables
     
     // Logging settings
     int log_level;
     bool show_stats;
     uint32_t stats_interval;
     
+    // Offline benchmark and autotune settings
+    bool benchmark;
+    uint32_t benchmark_duration; // Seconds per thread count or autotune trial
+    bool autotune;
+    std::string autotune_file;   // Where --autotune saves the best configuration
+    std::string tuning_cache;    // Tuning results per hardware fingerprint; empty disables
+    
     // Default constructor
     MinerConfig();
     
@@ -52,10 +70,18 @@ public:
     // Save configuration to file
     static bool saveToFile(const std::string& filename, const MinerConfig& config);
     
+    // Apply the tuning cached for a hardware fingerprint; false if there is none
+    static bool loadTuning(const std::string& filename, const std::string& fingerprint, MinerConfig& config);
+    
+    // Store the tuned settings of config for a fingerprint, keeping other entries
+    static bool saveTuning(const std::string& filename, const std::string& fingerprint, const MinerConfig& config);
+    
     // Print help
     static void printHelp();
     
 private:
+    friend struct MinerConfig;
+    
     // Parse command line argument
     static bool parseArg(const std::string& arg, MinerConfig& config);
     
@@ -0,0 +1,138 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "control_server.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// How often the accept loop checks for stop()
+const int POLL_INTERVAL_MS = 200;
+
+// Longest command line accepted from a client
+const size_t MAX_COMMAND = 256;
+
+} // namespace
+
+ControlServer::ControlServer()
+    : m_listen_fd(-1)
+    , m_should_stop(false)
+{
+}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+bool ControlServer::start(const std::string& path, Handler handler) {
+    sockaddr_un addr = {};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: Invalid control socket path: " << path << std::endl;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size());
+    
+    // A socket file left by a previous run would make bind() fail; anything
+    // else at the path is not ours to remove
+    struct stat existing;
+    if (::lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            std::cerr << "Error: Control socket path " << path << " exists and is not a socket" << std::endl;
+            return false;
+        }
+        ::unlink(path.c_str());
+    } else if (errno != ENOENT) {
+        std::cerr << "Error: Cannot check control socket path " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create control socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+        std::cerr << "Error: Cannot listen on control socket " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    
+    m_path = path;
+    m_handler = std::move(handler);
+    m_listen_fd = fd;
+    m_should_stop = false;
+    m_thread = std::thread(&ControlServer::serve, this);
+    return true;
+}
+
+void ControlServer::stop() {
+    if (m_listen_fd < 0) {
+        return;
+    }
+    
+    m_should_stop = true;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    ::close(m_listen_fd);
+    ::unlink(m_path.c_str());
+    m_listen_fd = -1;
+}
+
+void ControlServer::serve() {
+    while (!m_should_stop) {
+        pollfd listener = {m_listen_fd, POLLIN, 0};
+        if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            serveClient(fd);
+            ::close(fd);
+        }
+    }
+}
+
+void ControlServer::serveClient(int fd) {
+    std::string pending;
+    char buffer[MAX_COMMAND];
+    while (!m_should_stop) {
+        // Clients are local tools; one that goes quiet is dropped rather than waited on
+        pollfd client = {fd, POLLIN, 0};
+        if (poll(&client, 1, 5000) <= 0) {
+            return;
+        }
+        ssize_t got = ::read(fd, buffer, sizeof(buffer));
+        if (got <= 0) {
+            return;
+        }
+        pending.append(buffer, got);
+        
+        size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos) {
+            std::string command = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (!command.empty() && command.back() == '\r') {
+                command.pop_back();
+            }
+            std::string reply = m_handler(command) + "\n";
+            if (::send(fd, reply.data(), reply.size(), MSG_NOSIGNAL) < 0) {
+                return;
+            }
+        }
+        if (pending.size() > MAX_COMMAND) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_CONTROL_SERVER_H
+#define CPUMINER_CONTROL_SERVER_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * Local control interface on a UNIX domain socket. Each line a client
+ * sends is one command; the handler's result is written back as one line.
+ *
+ *   echo "threads 4" | socat - UNIX-CONNECT:/run/cpuminer.sock
+ */
+class ControlServer {
+public:
+    using Handler = std::function<std::string(const std::string& command)>;
+    
+    ControlServer();
+    ~ControlServer();
+    
+    // Listen on path, replacing a stale socket file; false on error
+    bool start(const std::string& path, Handler handler);
+    
+    // Close the socket and remove its file
+    void stop();
+
+private:
+    // Accept clients and answer their commands until stop()
+    void serve();
+    
+    // Answer every line from one client until it disconnects
+    void serveClient(int fd);
+    
+    std::string m_path;
+    Handler m_handler;
+    int m_listen_fd;
+    std::thread m_thread;
+    std::atomic<bool> m_should_stop;
+};
+
+#endif // CPUMINER_CONTROL_SERVER_H
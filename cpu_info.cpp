@@ -0,0 +1,389 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "cpu_info.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <cstring>
+#endif
+
+namespace CPUInfo {
+
+namespace {
+
+CPUFeatures DetectFeatures() {
+    CPUFeatures features = {};
+    
+#if defined(__x86_64__) || defined(__i386__)
+    // __builtin_cpu_supports also checks that the OS saves the wider registers
+    __builtin_cpu_init();
+    features.sse41 = __builtin_cpu_supports("sse4.1");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+    
+    // SHA extensions: CPUID leaf 7, EBX bit 29
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        features.sha = (ebx >> 29) & 1;
+    }
+#endif
+    
+    return features;
+}
+
+// Value of the first "key : value" line in /proc/cpuinfo; empty if absent
+std::string ReadProcCpuinfo(const std::string& key) {
+    std::ifstream file("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, colon);
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name == key) {
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            return value;
+        }
+    }
+    return "";
+}
+
+std::string DetectModelName() {
+#if defined(__x86_64__) || defined(__i386__)
+    // Brand string: CPUID leaves 0x80000002-0x80000004, 16 bytes each
+    unsigned int regs[12] = {};
+    if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004) {
+        for (unsigned int i = 0; i < 3; i++) {
+            __get_cpuid(0x80000002 + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3]);
+        }
+        char brand[sizeof(regs) + 1] = {};
+        std::memcpy(brand, regs, sizeof(regs));
+        std::string model = brand;
+        model.erase(0, model.find_first_not_of(' '));
+        model.erase(model.find_last_not_of(' ') + 1);
+        if (!model.empty()) {
+            return model;
+        }
+    }
+#endif
+    std::string model = ReadProcCpuinfo("model name");
+    return model.empty() ? "unknown" : model;
+}
+
+// Parse a Linux CPU list such as "0-3,8,10-11"; false if malformed
+bool ParseCpuList(const std::string& text, std::set<unsigned int>& cpus) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::string item = text.substr(pos, end - pos);
+        pos = end + 1;
+        
+        size_t dash = item.find('-');
+        std::string first = item.substr(0, dash);
+        std::string last = dash == std::string::npos ? first : item.substr(dash + 1);
+        if (first.empty() || last.empty() || first.find_first_not_of("0123456789") != std::string::npos ||
+            last.find_first_not_of("0123456789") != std::string::npos || first.size() > 6 || last.size() > 6) {
+            return false;
+        }
+        unsigned int low = std::stoul(first), high = std::stoul(last);
+        if (low > high) {
+            return false;
+        }
+        for (unsigned int cpu = low; cpu <= high; cpu++) {
+            cpus.insert(cpu);
+        }
+    }
+    return !cpus.empty();
+}
+
+// This process's cgroup v2 directory and its ancestors, innermost first
+std::vector<std::filesystem::path> CgroupDirs() {
+    std::vector<std::filesystem::path> dirs;
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        // The unified hierarchy is the "0::/path" entry
+        if (line.compare(0, 3, "0::") != 0) {
+            continue;
+        }
+        std::filesystem::path dir = "/sys/fs/cgroup";
+        dir += std::filesystem::path(line.substr(3)).lexically_normal();
+        for (; dir.has_relative_path() && dir != "/sys/fs"; dir = dir.parent_path()) {
+            dirs.push_back(dir);
+        }
+    }
+    return dirs;
+}
+
+// First line of a small sysfs or cgroup file; empty if missing
+std::string ReadLine(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+std::vector<CpuTopology> DetectAllowedCpus() {
+    std::set<unsigned int> allowed;
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                allowed.insert(cpu);
+            }
+        }
+    }
+    
+    // The affinity mask already follows the cpuset; the cgroup file also
+    // covers a mask set before the process moved into a narrower cgroup
+    for (const std::filesystem::path& dir : CgroupDirs()) {
+        std::set<unsigned int> cpuset;
+        if (ParseCpuList(ReadLine(dir / "cpuset.cpus.effective"), cpuset)) {
+            std::set<unsigned int> both;
+            std::set_intersection(allowed.begin(), allowed.end(), cpuset.begin(), cpuset.end(),
+                                  std::inserter(both, both.begin()));
+            if (!both.empty()) {
+                allowed.swap(both);
+            }
+            break;
+        }
+    }
+#endif
+    if (allowed.empty()) {
+        for (unsigned int cpu = 0; cpu < LogicalCpuCount(); cpu++) {
+            allowed.insert(cpu);
+        }
+    }
+    
+    std::vector<CpuTopology> cpus;
+    for (unsigned int cpu : allowed) {
+        // Without sysfs every CPU is its own core on node 0
+        CpuTopology topology = {cpu, 0, static_cast<int>(cpu), 0};
+        const std::filesystem::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        std::ifstream package_file(dir / "topology" / "physical_package_id");
+        std::ifstream core_file(dir / "topology" / "core_id");
+        int package = 0, core = 0;
+        if (package_file >> package && core_file >> core) {
+            topology.package = package;
+            topology.core = core;
+        }
+        
+        // The CPU's directory links to its NUMA node as nodeN
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                name.find_first_not_of("0123456789", 4) == std::string::npos) {
+                topology.node = std::stoi(name.substr(4));
+                break;
+            }
+        }
+        cpus.push_back(topology);
+    }
+    return cpus;
+}
+
+unsigned int DetectCpuQuota() {
+    // Every level of the hierarchy limits the process; the tightest wins
+    unsigned int quota = 0;
+    for (const std::filesystem::path& dir : CgroupDirs()) {
+        std::istringstream line(ReadLine(dir / "cpu.max"));
+        std::string max;
+        uint64_t period = 0;
+        if (!(line >> max >> period) || max == "max" || period == 0 ||
+            max.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        // Round down: a thread that outruns the quota is throttled for the
+        // rest of the period, which costs more than leaving a fraction idle
+        unsigned int cpus = std::max<uint64_t>(std::stoull(max) / period, 1);
+        quota = quota == 0 ? cpus : std::min(quota, cpus);
+    }
+    return quota;
+}
+
+} // namespace
+
+const CPUFeatures& GetFeatures() {
+    static const CPUFeatures features = DetectFeatures();
+    return features;
+}
+
+std::string FeatureString() {
+    const CPUFeatures& features = GetFeatures();
+    std::string result;
+    
+    auto append = [&result](bool present, const char* name) {
+        if (!present) {
+            return;
+        }
+        if (!result.empty()) {
+            result += " ";
+        }
+        result += name;
+    };
+    
+    append(features.sse41, "sse4.1");
+    append(features.avx2, "avx2");
+    append(features.avx512f, "avx512f");
+    append(features.sha, "sha");
+    
+    return result.empty() ? "none" : result;
+}
+
+unsigned int LogicalCpuCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+unsigned int PhysicalCoreCount() {
+    static const unsigned int count = [] {
+        std::set<std::pair<int, int>> cores;
+        for (const CpuTopology& cpu : AllowedCpus()) {
+            cores.insert({cpu.package, cpu.core});
+        }
+        return static_cast<unsigned int>(std::max<size_t>(cores.size(), 1));
+    }();
+    return count;
+}
+
+const std::vector<CpuTopology>& AllowedCpus() {
+    static const std::vector<CpuTopology> cpus = DetectAllowedCpus();
+    return cpus;
+}
+
+unsigned int CpuQuota() {
+    static const unsigned int quota = DetectCpuQuota();
+    return quota;
+}
+
+unsigned int UsableCpuCount() {
+    unsigned int count = AllowedCpus().size();
+    unsigned int quota = CpuQuota();
+    return quota > 0 ? std::min(count, quota) : count;
+}
+
+bool PlanAffinity(const std::string& policy, unsigned int threads, std::vector<unsigned int>& cpus) {
+    cpus.clear();
+    const std::vector<CpuTopology>& allowed = AllowedCpus();
+    if (policy == "none") {
+        return true;
+    }
+    
+    std::vector<unsigned int> order;
+    if (policy == "cores" || policy == "smt") {
+        // Siblings of each core, and the cores of each NUMA node
+        std::map<std::pair<int, int>, std::vector<unsigned int>> siblings;
+        std::map<int, std::vector<std::pair<int, int>>> nodes;
+        for (const CpuTopology& cpu : allowed) {
+            std::vector<unsigned int>& core = siblings[{cpu.package, cpu.core}];
+            if (core.empty()) {
+                nodes[cpu.node].push_back({cpu.package, cpu.core});
+            }
+            core.push_back(cpu.cpu);
+        }
+        
+        // Take cores from each node in turn so both sockets fill evenly
+        std::vector<std::pair<int, int>> cores;
+        for (size_t i = 0; cores.size() < siblings.size(); i++) {
+            for (const auto& node : nodes) {
+                if (i < node.second.size()) {
+                    cores.push_back(node.second[i]);
+                }
+            }
+        }
+        
+        if (policy == "smt") {
+            for (const auto& core : cores) {
+                order.insert(order.end(), siblings[core].begin(), siblings[core].end());
+            }
+        } else {
+            for (size_t sibling = 0; order.size() < allowed.size(); sibling++) {
+                for (const auto& core : cores) {
+                    if (sibling < siblings[core].size()) {
+                        order.push_back(siblings[core][sibling]);
+                    }
+                }
+            }
+        }
+    } else {
+        std::set<unsigned int> listed;
+        if (!ParseCpuList(policy, listed)) {
+            return false;
+        }
+        for (unsigned int cpu : listed) {
+            auto it = std::find_if(allowed.begin(), allowed.end(),
+                                   [cpu](const CpuTopology& topology) { return topology.cpu == cpu; });
+            if (it == allowed.end()) {
+                return false;
+            }
+            order.push_back(cpu);
+        }
+    }
+    
+    // More threads than CPUs share them round-robin
+    for (unsigned int i = 0; i < threads && !order.empty(); i++) {
+        cpus.push_back(order[i % order.size()]);
+    }
+    return true;
+}
+
+bool PinThread(unsigned int cpu) {
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+std::string ModelName() {
+    static const std::string model = DetectModelName();
+    return model;
+}
+
+std::string Microcode() {
+    static const std::string microcode = [] {
+        std::string value = ReadProcCpuinfo("microcode");
+        return value.empty() ? std::string("unknown") : value;
+    }();
+    return microcode;
+}
+
+std::string Fingerprint() {
+    return ModelName() + "; microcode " + Microcode() + "; " + FeatureString() + "; " +
+           std::to_string(PhysicalCoreCount()) + " cores, " + std::to_string(UsableCpuCount()) + " threads";
+}
+
+} // namespace CPUInfo
@@ -0,0 +1,71 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_CPU_INFO_H
+#define CPUMINER_CPU_INFO_H
+
+#include <string>
+#include <vector>
+
+// Instruction set extensions usable on this CPU (checked with cpuid at runtime)
+struct CPUFeatures {
+    bool sse41;
+    bool avx2;
+    bool avx512f;
+    bool sha;
+};
+
+// Position of one logical CPU in the machine, from Linux sysfs
+struct CpuTopology {
+    unsigned int cpu;
+    int package;
+    int core;
+    int node; // NUMA node; 0 where none is exposed
+};
+
+namespace CPUInfo {
+    // Detect CPU features once and return the cached result
+    const CPUFeatures& GetFeatures();
+    
+    // Space separated list of detected features, e.g. "sse4.1 avx2 sha"
+    std::string FeatureString();
+    
+    // Number of logical CPUs (hardware threads)
+    unsigned int LogicalCpuCount();
+    
+    // Number of physical cores among the allowed CPUs, counting SMT siblings
+    // once; falls back to the logical CPU count where the topology is not exposed
+    unsigned int PhysicalCoreCount();
+    
+    // Logical CPUs this process may run on: the affinity mask intersected
+    // with the cgroup v2 cpuset, ordered by CPU number
+    const std::vector<CpuTopology>& AllowedCpus();
+    
+    // CPU time the cgroup v2 cpu.max quotas allow, in whole CPUs; 0 if unlimited
+    unsigned int CpuQuota();
+    
+    // CPUs the miner can keep busy: the allowed CPUs, capped by the quota
+    unsigned int UsableCpuCount();
+    
+    // Pick a CPU for each of threads under policy: "none" (empty result),
+    // "cores" (one thread per physical core, then SMT siblings), "smt" (all
+    // siblings of a core before the next) or a list such as "0,2,4-7".
+    // Cores alternate between NUMA nodes. False if policy is malformed or
+    // lists a CPU outside AllowedCpus().
+    bool PlanAffinity(const std::string& policy, unsigned int threads, std::vector<unsigned int>& cpus);
+    
+    // Pin the calling thread to one logical CPU; false where unsupported
+    bool PinThread(unsigned int cpu);
+    
+    // CPU brand string, e.g. "AMD EPYC 7763 64-Core Processor"
+    std::string ModelName();
+    
+    // Microcode revision from /proc/cpuinfo, or "unknown"
+    std::string Microcode();
+    
+    // Hardware identity for cached tuning: model, microcode, features and core counts
+    std::string Fingerprint();
+}
+
+#endif // CPUMINER_CPU_INFO_H
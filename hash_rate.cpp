@@ -0,0 +1,79 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "hash_rate.h"
+#include <algorithm>
+#include <cmath>
+
+void HashRateMeter::Sample(Clock::time_point now, uint64_t hashes) {
+    if (!m_samples.empty()) {
+        const Point& last = m_samples.back();
+        if (hashes < last.hashes) {
+            Reset();
+        } else {
+            double elapsed = std::chrono::duration<double>(now - last.time).count();
+            if (elapsed <= 0) {
+                return;
+            }
+            
+            // The first interval seeds the average; later ones decay it by elapsed time
+            double rate = static_cast<double>(hashes - last.hashes) / elapsed;
+            if (m_samples.size() == 1) {
+                m_ewma = rate;
+            } else {
+                double weight = 1.0 - std::exp(-elapsed / std::chrono::duration<double>(EWMA_TIME_CONSTANT).count());
+                m_ewma += weight * (rate - m_ewma);
+            }
+        }
+    }
+    m_samples.push_back({now, hashes});
+    
+    // Keep one sample at or before the start of the longest window
+    while (m_samples.size() > 2 && m_samples[1].time <= now - LONGEST_WINDOW) {
+        m_samples.pop_front();
+    }
+}
+
+double HashRateMeter::Rate(Clock::duration window) const {
+    if (m_samples.size() < 2 || window <= Clock::duration::zero()) {
+        return 0.0;
+    }
+    const Point& last = m_samples.back();
+    Clock::time_point start = last.time - window;
+    
+    // First sample inside the window; the counter at its start is
+    // interpolated from the sample before it
+    auto inside = std::lower_bound(m_samples.begin(), m_samples.end(), start,
+                                   [](const Point& point, Clock::time_point time) { return point.time < time; });
+    double start_hashes;
+    if (inside == m_samples.begin()) {
+        start = inside->time;
+        start_hashes = static_cast<double>(inside->hashes);
+    } else {
+        const Point& before = *(inside - 1);
+        double fraction = std::chrono::duration<double>(start - before.time).count() /
+                          std::chrono::duration<double>(inside->time - before.time).count();
+        start_hashes = before.hashes + fraction * static_cast<double>(inside->hashes - before.hashes);
+    }
+    
+    double elapsed = std::chrono::duration<double>(last.time - start).count();
+    if (elapsed <= 0) {
+        return 0.0;
+    }
+    return (static_cast<double>(last.hashes) - start_hashes) / elapsed;
+}
+
+HashRates HashRateMeter::Rates() const {
+    HashRates rates;
+    rates.rate_10s = Rate(std::chrono::seconds(10));
+    rates.rate_60s = Rate(std::chrono::seconds(60));
+    rates.rate_15m = Rate(LONGEST_WINDOW);
+    rates.ewma = m_ewma;
+    return rates;
+}
+
+void HashRateMeter::Reset() {
+    m_samples.clear();
+    m_ewma = 0.0;
+}
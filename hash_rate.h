@@ -0,0 +1,57 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_HASH_RATE_H
+#define CPUMINER_HASH_RATE_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+// Recent hash rates in hashes per second
+struct HashRates {
+    double rate_10s = 0.0;
+    double rate_60s = 0.0;
+    double rate_15m = 0.0;
+    double ewma = 0.0;          // Exponentially weighted, 30 s time constant
+};
+
+/**
+ * Hash rates from timestamped samples of a cumulative hash counter. The
+ * window rates interpolate the counter at the window start between the two
+ * samples around it, so they do not depend on when samples were taken; a
+ * window longer than the recorded history covers the history instead.
+ * Samples older than the longest window are dropped. Not thread-safe.
+ */
+class HashRateMeter {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr std::chrono::seconds LONGEST_WINDOW{15 * 60};
+    static constexpr std::chrono::seconds EWMA_TIME_CONSTANT{30};
+    
+    // Record the counter at now. A counter lower than the last sample was
+    // reset, and restarts the history.
+    void Sample(Clock::time_point now, uint64_t hashes);
+    
+    // Average rate over the window ending at the last sample
+    double Rate(Clock::duration window) const;
+    
+    double Ewma() const { return m_ewma; }
+    
+    HashRates Rates() const;
+    
+    void Reset();
+
+private:
+    struct Point {
+        Clock::time_point time;
+        uint64_t hashes;
+    };
+    
+    std::deque<Point> m_samples;
+    double m_ewma = 0.0;
+};
+
+#endif // CPUMINER_HASH_RATE_H
@@ -24,14 +24,20 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        // Offline benchmark or autotune instead of mining
+        if (miner.isAutotune()) {
+            return miner.runAutotune() ? 0 : 1;
+        }
+        if (miner.isBenchmark()) {
+            return miner.runBenchmark() ? 0 : 1;
+        }
+        
         // Start mining
         std::cout << "Starting miner..." << std::endl;
         miner.start();
         
-        // Wait for stop signal
-        while (miner.isRunning()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        // Wait for SIGINT or SIGTERM
+        miner.waitForStop();
         
         // Print final statistics
         std::cout << "\nFinal Statistics:" << std::endl;
@@ -3,18 +3,63 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "miner.h"
+#include "cpu_info.h"
+#include "randomq_kernel.h"
+#include "randomq_mining.h"
+#include <algorithm>
 #include <iostream>
 #include <csignal>
+#include <pthread.h>
 #include <chrono>
 #include <iomanip>
 #include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Nonce batch sizes tried by --autotune
+const uint32_t AUTOTUNE_NONCE_BATCHES[] = {64, 256, 1024, 4096};
+
+// Most threads a reload or the control socket may ask for, per usable CPU
+const int MAX_THREADS_PER_CPU = 4;
+
+// Signals taken by the signal thread; blocked in every other thread
+sigset_t HandledSignals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    return signals;
+}
+
+// Work for --benchmark and --autotune; the all-zero target is never met, so no thread stops early
+WorkData MakeBenchmarkWork() {
+    WorkData work;
+    work.block_template = "benchmark";
+    work.previous_block_hash = "000000000000000000000000000000000000000000000000000000000000b0b0";
+    work.merkle_root = "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b";
+    work.target = "0000000000000000000000000000000000000000000000000000000000000000";
+    work.version = 0x20000000;
+    work.timestamp = 1700000000;
+    work.bits = 0x1d00ffff;
+    work.height = 1;
+    work.nonce_start = 0;
+    work.nonce_end = 0xFFFFFFFF;
+    return work;
+}
+
+} // namespace
 
 // Static member initialization
 std::atomic<bool> Miner::s_should_stop(false);
+std::atomic<bool> Miner::s_reload(false);
 
 Miner::Miner()
     : m_running(false)
     , m_should_stop(false)
+    , m_signal_exit(false)
     , m_total_blocks_found(0)
     , m_total_blocks_submitted(0)
     , m_total_blocks_accepted(0)
@@ -22,14 +67,22 @@ Miner::Miner()
     , m_show_stats(true)
     , m_stats_interval(10)
 {
-    // Set up signal handlers
-    std::signal(SIGINT, signalHandler);
-    std::signal(SIGTERM, signalHandler);
+    // Block the signals before any other thread starts, so they all inherit
+    // the mask and only the signal thread receives them
+    sigset_t signals = HandledSignals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    m_signal_thread = std::thread(&Miner::signalThread, this);
 }
 
 Miner::~Miner() {
     stop();
     cleanup();
+    
+    m_signal_exit = true;
+    pthread_kill(m_signal_thread.native_handle(), SIGHUP);
+    m_signal_thread.join();
+    sigset_t signals = HandledSignals();
+    pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
 }
 
 bool Miner::initialize(int argc, char* argv[]) {
@@ -51,6 +104,25 @@ bool Miner::initialize(int argc, char* argv[]) {
         return false;
     }
     
+    // Reuse cached tuning for this hardware, autotuning only when there is none
+    if (!m_config.tuning_cache.empty() && !m_config.benchmark && !m_config.autotune) {
+        const std::string fingerprint = tuningFingerprint();
+        MinerConfig tuned = m_config;
+        if (ConfigManager::loadTuning(m_config.tuning_cache, fingerprint, tuned)) {
+            log(2, "Using cached tuning for " + fingerprint);
+        } else {
+            log(2, "No cached tuning for " + fingerprint + ", autotuning");
+            if (!autotune(tuned)) {
+                return false;
+            }
+            ConfigManager::saveTuning(m_config.tuning_cache, fingerprint, tuned);
+        }
+        m_config = tuned;
+        configureRandomQMiner();
+        log(2, "Tuning: kernel " + m_config.kernel + ", nonce batch " + std::to_string(m_config.nonce_batch) +
+               ", " + std::to_string(m_config.num_threads) + " threads, affinity " + m_config.affinity);
+    }
+    
     log(2, "Miner initialized successfully");
     return true;
 }
@@ -64,9 +136,17 @@ bool Miner::initializeComponents() {
     }
     
     // Configure RandomQ miner
-    m_randomq_miner->setThreadCount(m_config.num_threads);
-    m_randomq_miner->setRandomQRounds(m_config.randomq_rounds);
-    m_randomq_miner->setOptimizations(m_config.enable_avx2, m_config.enable_sse4, m_config.enable_optimized);
+    configureRandomQMiner();
+    
+    // Apply logging configuration
+    m_log_level = m_config.log_level;
+    m_show_stats = m_config.show_stats;
+    m_stats_interval = m_config.stats_interval;
+    
+    // The benchmark and autotuner hash generated work and need no node
+    if (m_config.benchmark || m_config.autotune) {
+        return true;
+    }
     
     // Create RPC client
     m_rpc_client = std::make_unique<RPCClient>();
@@ -79,14 +159,52 @@ bool Miner::initializeComponents() {
     // Set miner reference in RPC client
     m_rpc_client->setMiner(m_randomq_miner.get());
     
-    // Apply logging configuration
-    m_log_level = m_config.log_level;
-    m_show_stats = m_config.show_stats;
-    m_stats_interval = m_config.stats_interval;
+    // A solved or exhausted job asks for a template right away
+    RPCClient* rpc_client = m_rpc_client.get();
+    m_randomq_miner->setWorkRequest([rpc_client] { rpc_client->requestWork(); });
     
     return true;
 }
 
+int Miner::applySmtLimit(int count) {
+    // Without SMT, run at most one thread per physical core
+    int physical_cores = static_cast<int>(CPUInfo::PhysicalCoreCount());
+    if (!m_config.use_smt && count > physical_cores) {
+        log(2, "SMT disabled, limiting threads to " + std::to_string(physical_cores) + " physical cores");
+        return physical_cores;
+    }
+    return count;
+}
+
+int Miner::maxThreadCount() const {
+    return static_cast<int>(CPUInfo::UsableCpuCount()) * MAX_THREADS_PER_CPU;
+}
+
+void Miner::configureRandomQMiner() {
+    m_config.num_threads = applySmtLimit(m_config.num_threads);
+    
+    // More threads than the cpuset and cpu.max quota allow only time-slice
+    unsigned int usable_cpus = CPUInfo::UsableCpuCount();
+    if (m_config.num_threads > static_cast<int>(usable_cpus)) {
+        log(1, std::to_string(m_config.num_threads) + " threads requested but only " + std::to_string(usable_cpus) +
+               " CPUs are usable under the CPU affinity and cgroup limits");
+    }
+    
+    m_randomq_miner->setThreadCount(m_config.num_threads);
+    m_randomq_miner->setRandomQRounds(m_config.randomq_rounds);
+    m_randomq_miner->setOptimizations(m_config.enable_avx2, m_config.enable_sse4, m_config.enable_optimized);
+    m_randomq_miner->setKernel(m_config.kernel);
+    m_randomq_miner->setNonceBatch(m_config.nonce_batch);
+    m_randomq_miner->setVerifySample(m_config.verify_sample);
+    m_randomq_miner->setRolling(m_config.version_mask, m_config.ntime_roll);
+    m_randomq_miner->setAffinity(m_config.affinity);
+}
+
+std::string Miner::tuningFingerprint() const {
+    // Tuning depends on the round count as well as the hardware
+    return CPUInfo::Fingerprint() + "; rounds " + std::to_string(m_config.randomq_rounds);
+}
+
 void Miner::start() {
     if (m_running) {
         log(1, "Miner is already running");
@@ -111,6 +229,14 @@ void Miner::start() {
         m_stats_thread = std::thread(&Miner::statsThread, this);
     }
     
+    if (!m_config.control_socket.empty()) {
+        if (m_control.start(m_config.control_socket, [this](const std::string& command) { return handleControl(command); })) {
+            log(2, "Control socket listening on " + m_config.control_socket);
+        } else {
+            log(1, "Control socket disabled");
+        }
+    }
+    
     log(2, "Miner started");
 }
 
@@ -122,6 +248,10 @@ void Miner::stop() {
     log(2, "Stopping miner...");
     m_should_stop = true;
     s_should_stop = true;
+    wake();
+    
+    // No commands may reach the RandomQ miner while it stops
+    m_control.stop();
     
     // Stop RandomQ miner
     if (m_randomq_miner) {
@@ -147,6 +277,180 @@ void Miner::stop() {
     log(2, "Miner stopped");
 }
 
+bool Miner::runBenchmark() {
+    struct BenchmarkStep {
+        int threads;
+        double hash_rate;
+    };
+    
+    const int max_threads = static_cast<int>(CPUInfo::UsableCpuCount());
+    
+    log(2, "Benchmark: 1-" + std::to_string(max_threads) + " threads, " +
+           std::to_string(m_config.benchmark_duration) + " seconds each, " +
+           std::to_string(m_config.randomq_rounds) + " rounds");
+    m_randomq_miner->setWork(MakeBenchmarkWork());
+    
+    std::vector<BenchmarkStep> steps;
+    for (int threads = 1; threads <= max_threads && !s_should_stop; threads++) {
+        double hash_rate = measureHashRate(threads);
+        steps.push_back({threads, hash_rate});
+        log(2, "Benchmark " + std::to_string(threads) + " threads: " +
+               RandomQMining::MiningUtils::FormatHashRate(hash_rate));
+    }
+    
+    if (steps.empty()) {
+        return false;
+    }
+    
+    // Saturation: the fewest threads that reach 95% of the best aggregate rate
+    double best_rate = 0.0;
+    for (const BenchmarkStep& step : steps) {
+        best_rate = std::max(best_rate, step.hash_rate);
+    }
+    int saturation_threads = steps.back().threads;
+    for (const BenchmarkStep& step : steps) {
+        if (step.hash_rate >= 0.95 * best_rate) {
+            saturation_threads = step.threads;
+            break;
+        }
+    }
+    
+    const double single_rate = steps.front().hash_rate;
+    std::cout << "\n=== Benchmark Results ===" << std::endl;
+    std::cout << "Kernel: " << m_randomq_miner->getStats().kernel << std::endl;
+    std::cout << "RandomQ Rounds: " << m_config.randomq_rounds << std::endl;
+    std::cout << std::left << std::setw(10) << "Threads" << std::setw(16) << "Aggregate"
+              << std::setw(16) << "Per Thread" << "Efficiency" << std::endl;
+    for (const BenchmarkStep& step : steps) {
+        double efficiency = single_rate > 0 ? step.hash_rate / (step.threads * single_rate) * 100.0 : 0.0;
+        std::cout << std::left << std::setw(10) << step.threads
+                  << std::setw(16) << RandomQMining::MiningUtils::FormatHashRate(step.hash_rate)
+                  << std::setw(16) << RandomQMining::MiningUtils::FormatHashRate(step.hash_rate / step.threads)
+                  << std::fixed << std::setprecision(1) << efficiency << "%"
+                  << (step.threads == saturation_threads ? "  <- saturation" : "") << std::endl;
+    }
+    std::cout << "Adding threads beyond " << saturation_threads << " gains less than 5%" << std::endl;
+    std::cout << "=========================" << std::endl;
+    
+    return true;
+}
+
+bool Miner::runAutotune() {
+    MinerConfig tuned = m_config;
+    if (!autotune(tuned)) {
+        log(1, "Configuration not saved");
+        return false;
+    }
+    
+    if (!ConfigManager::saveToFile(m_config.autotune_file, tuned)) {
+        return false;
+    }
+    log(2, "Saved tuned configuration to " + m_config.autotune_file);
+    
+    if (!m_config.tuning_cache.empty() && ConfigManager::saveTuning(m_config.tuning_cache, tuningFingerprint(), tuned)) {
+        log(2, "Updated tuning cache " + m_config.tuning_cache);
+    }
+    return true;
+}
+
+bool Miner::autotune(MinerConfig& tuned) {
+    struct AutotuneTrial {
+        std::string kernel;
+        uint32_t nonce_batch;
+        int threads;
+        double hash_rate;
+    };
+    
+    // Only the CPUs the cpuset and cgroup quota leave this process
+    const int logical_cpus = static_cast<int>(CPUInfo::UsableCpuCount());
+    const int physical_cores = std::min(static_cast<int>(CPUInfo::PhysicalCoreCount()), logical_cpus);
+    log(2, "Autotune: " + std::to_string(physical_cores) + " physical cores, " +
+           std::to_string(logical_cpus) + " logical CPUs, " +
+           std::to_string(m_config.benchmark_duration) + " seconds per trial");
+    m_randomq_miner->setWork(MakeBenchmarkWork());
+    
+    std::vector<AutotuneTrial> trials;
+    AutotuneTrial best = {"auto", m_config.nonce_batch, physical_cores, 0.0};
+    auto run_trial = [&](const std::string& kernel, uint32_t nonce_batch, int threads) {
+        m_randomq_miner->setKernel(kernel);
+        m_randomq_miner->setNonceBatch(nonce_batch);
+        AutotuneTrial trial = {kernel, nonce_batch, threads, measureHashRate(threads)};
+        trials.push_back(trial);
+        log(2, "Autotune " + kernel + ", batch " + std::to_string(nonce_batch) + ", " +
+               std::to_string(threads) + " threads: " + RandomQMining::MiningUtils::FormatHashRate(trial.hash_rate));
+        if (trial.hash_rate > best.hash_rate) {
+            best = trial;
+        }
+    };
+    
+    // One setting at a time, keeping the best of each stage: lane width
+    // (the kernel), then nonce batch, then thread count and SMT
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!s_should_stop && RandomQKernel::IsSupported(kernel) &&
+            RandomQKernel::IsAllowed(kernel, m_config.enable_avx2, m_config.enable_sse4)) {
+            run_trial(kernel.name, best.nonce_batch, physical_cores);
+        }
+    }
+    for (uint32_t nonce_batch : AUTOTUNE_NONCE_BATCHES) {
+        if (!s_should_stop && nonce_batch != best.nonce_batch) {
+            run_trial(best.kernel, nonce_batch, physical_cores);
+        }
+    }
+    std::vector<int> thread_counts = {physical_cores - 1, logical_cpus};
+    for (int threads : thread_counts) {
+        if (!s_should_stop && threads >= 1 && threads != physical_cores) {
+            run_trial(best.kernel, best.nonce_batch, threads);
+        }
+    }
+    
+    // Drop the generated work so mining waits for a real template
+    m_randomq_miner->clearWork();
+    
+    if (s_should_stop || best.hash_rate <= 0.0) {
+        log(1, "Autotune interrupted");
+        return false;
+    }
+    
+    std::cout << "\n=== Autotune Results ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "Kernel" << std::setw(8) << "Batch"
+              << std::setw(10) << "Threads" << "Hash Rate" << std::endl;
+    for (const AutotuneTrial& trial : trials) {
+        std::cout << std::left << std::setw(10) << trial.kernel << std::setw(8) << trial.nonce_batch
+                  << std::setw(10) << trial.threads << RandomQMining::MiningUtils::FormatHashRate(trial.hash_rate)
+                  << std::endl;
+    }
+    
+    tuned.num_threads = best.threads;
+    tuned.kernel = best.kernel;
+    tuned.nonce_batch = best.nonce_batch;
+    tuned.use_smt = best.threads > physical_cores;
+    std::cout << "Best: kernel " << tuned.kernel << ", nonce batch " << tuned.nonce_batch
+              << ", " << tuned.num_threads << " threads (SMT " << (tuned.use_smt ? "on" : "off") << "), "
+              << RandomQMining::MiningUtils::FormatHashRate(best.hash_rate) << std::endl;
+    std::cout << "========================" << std::endl;
+    
+    return true;
+}
+
+double Miner::measureHashRate(int threads) {
+    m_randomq_miner->setThreadCount(threads);
+    uint64_t hashes_before = m_randomq_miner->getStats().total_hashes;
+    
+    m_randomq_miner->start();
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(m_config.benchmark_duration);
+    {
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        m_wake_cv.wait_until(lock, deadline, [] { return s_should_stop.load(); });
+    }
+    // stop() joins the threads, which count their last batch on exit
+    m_randomq_miner->stop();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    uint64_t hashes = m_randomq_miner->getStats().total_hashes - hashes_before;
+    return RandomQMining::MiningUtils::CalculateHashRate(hashes, elapsed);
+}
+
 void Miner::printStats() const {
     std::lock_guard<std::mutex> lock(m_stats_mutex);
     
@@ -167,22 +471,55 @@ void Miner::printStats() const {
     
     // Print RandomQ miner stats
     if (m_randomq_miner) {
-        MiningStats randomq_stats = m_randomq_miner->getStats();
-        std::cout << "\nRandomQ Miner Stats:" << std::endl;
-        std::cout << "Total Hashes: " << randomq_stats.total_hashes << std::endl;
-        std::cout << "Hash Rate: " << std::fixed << std::setprecision(2) 
-                  << randomq_stats.hash_rate << " H/s" << std::endl;
-        std::cout << "Valid Blocks: " << randomq_stats.valid_blocks << std::endl;
-        std::cout << "Invalid Blocks: " << randomq_stats.invalid_blocks << std::endl;
-        std::cout << "Elapsed Time: " << randomq_stats.elapsed_time << " seconds" << std::endl;
+        std::cout << "=======================" << std::endl;
+        m_randomq_miner->getStats().print();
+    } else {
+        std::cout << "=======================" << std::endl;
     }
-    
-    std::cout << "=======================" << std::endl;
 }
 
-void Miner::signalHandler(int signal) {
-    std::cout << "\nReceived signal " << signal << ", stopping miner..." << std::endl;
-    s_should_stop = true;
+void Miner::waitForStop() {
+    {
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        m_wake_cv.wait(lock, [this] { return m_should_stop || s_should_stop; });
+    }
+    stop();
+}
+
+void Miner::signalThread() {
+    const sigset_t signals = HandledSignals();
+    while (true) {
+        int signal = 0;
+        if (sigwait(&signals, &signal) != 0) {
+            continue;
+        }
+        if (m_signal_exit) {
+            return;
+        }
+        
+        if (signal == SIGHUP) {
+            // Reload is picked up by the mining loop
+            s_reload = true;
+        } else {
+            std::cout << "\nReceived signal " << signal << ", stopping miner..." << std::endl;
+            s_should_stop = true;
+        }
+        wake();
+    }
+}
+
+void Miner::wake() {
+    // Waiters check the flags under the mutex, so taking it here means none
+    // can miss a flag set just before this notification
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+    }
+    m_wake_cv.notify_all();
+}
+
+void Miner::waitFor(std::chrono::steady_clock::duration timeout) {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    m_wake_cv.wait_for(lock, timeout, [this] { return m_should_stop || s_should_stop || s_reload; });
 }
 
 void Miner::miningLoop() {
@@ -190,31 +527,112 @@ void Miner::miningLoop() {
     
     while (!m_should_stop && !s_should_stop) {
         try {
+            if (s_reload.exchange(false)) {
+                reloadConfig();
+            }
+            
             // Check if we have work
             if (m_rpc_client && m_rpc_client->isConnected()) {
-                WorkData work = m_rpc_client->getCurrentWork();
-                if (work.isValid()) {
-                    // Work is already set in the RandomQ miner by the RPC client
-                    // Just wait and monitor
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                std::shared_ptr<const WorkData> work = m_rpc_client->getCurrentWork();
+                if (work && work->isValid()) {
+                    // Work is already set in the RandomQ miner by the RPC client;
+                    // wake for stop and reload, and re-check the connection now and then
+                    waitFor(std::chrono::seconds(5));
                 } else {
                     log(1, "No valid work available, waiting...");
-                    std::this_thread::sleep_for(std::chrono::seconds(5));
+                    waitFor(std::chrono::seconds(5));
                 }
             } else {
                 log(1, "RPC client not connected, waiting...");
-                std::this_thread::sleep_for(std::chrono::seconds(5));
+                waitFor(std::chrono::seconds(5));
             }
             
         } catch (const std::exception& e) {
             log(0, "Mining loop error: " + std::string(e.what()));
-            std::this_thread::sleep_for(std::chrono::seconds(5));
+            waitFor(std::chrono::seconds(5));
         }
     }
     
     log(2, "Main mining loop stopped");
 }
 
+bool Miner::reloadConfig() {
+    std::lock_guard<std::mutex> lock(m_config_mutex);
+    if (m_config.config_file.empty()) {
+        log(1, "Reload requested, but no --config file was given");
+        return false;
+    }
+    
+    // Runs on the signal-driven mining loop or the control thread; a bad
+    // value in the file must fail the reload, not end the process
+    MinerConfig reloaded = m_config;
+    bool loaded = false;
+    try {
+        loaded = ConfigManager::loadFromFile(m_config.config_file, reloaded) && reloaded.validate();
+    } catch (const std::exception& e) {
+        log(0, "Cannot parse " + m_config.config_file + ": " + e.what());
+    }
+    if (!loaded) {
+        log(0, "Reload of " + m_config.config_file + " failed, keeping the current settings");
+        return false;
+    }
+    if (reloaded.num_threads > maxThreadCount()) {
+        log(0, "Reload of " + m_config.config_file + " asks for " + std::to_string(reloaded.num_threads) +
+               " threads, more than " + std::to_string(maxThreadCount()) + "; keeping the current settings");
+        return false;
+    }
+    
+    // Only the thread count changes live; the rest applies at the next start
+    int num_threads = applySmtLimit(reloaded.num_threads);
+    if (num_threads != m_config.num_threads) {
+        m_config.num_threads = num_threads;
+        m_randomq_miner->setThreadCount(m_config.num_threads);
+    }
+    log(2, "Reloaded " + m_config.config_file + ": " + std::to_string(m_config.num_threads) + " threads");
+    return true;
+}
+
+std::string Miner::handleControl(const std::string& command) {
+    // An exception here would end the control thread and the process with it
+    try {
+        return runControlCommand(command);
+    } catch (const std::exception& e) {
+        log(0, "Control command \"" + command + "\" failed: " + e.what());
+        return "error " + std::string(e.what());
+    }
+}
+
+std::string Miner::runControlCommand(const std::string& command) {
+    std::istringstream in(command);
+    std::string verb;
+    in >> verb;
+    
+    if (verb == "threads") {
+        int count = 0;
+        if (in >> count) {
+            if (count <= 0) {
+                return "error thread count must be at least 1";
+            }
+            if (count > maxThreadCount()) {
+                return "error thread count must be at most " + std::to_string(maxThreadCount());
+            }
+            std::lock_guard<std::mutex> lock(m_config_mutex);
+            m_config.num_threads = applySmtLimit(count);
+            m_randomq_miner->setThreadCount(m_config.num_threads);
+        }
+        return "threads " + std::to_string(m_randomq_miner->getThreadCount());
+    }
+    if (verb == "reload") {
+        return reloadConfig() ? "ok" : "error reload failed";
+    }
+    if (verb == "stats") {
+        MiningStats stats = m_randomq_miner->getStats();
+        return "threads " + std::to_string(m_randomq_miner->getThreadCount()) + " hashes " +
+               std::to_string(stats.total_hashes) + " rate " + RandomQMining::MiningUtils::FormatHashRate(stats.rates);
+    }
+    return "error unknown command, expected: threads [N], reload, stats";
+}
+
 void Miner::statsThread() {
     log(2, "Statistics thread started");
     
@@ -223,12 +641,13 @@ void Miner::statsThread() {
             // Print statistics
             printStats();
             
-            // Wait for next update
-            std::this_thread::sleep_for(std::chrono::seconds(m_stats_interval));
+            // Wait for next update; stop() ends the wait
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_cv.wait_for(lock, std::chrono::seconds(m_stats_interval), [this] { return m_should_stop || s_should_stop; });
             
         } catch (const std::exception& e) {
             log(0, "Statistics thread error: " + std::string(e.what()));
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            waitFor(std::chrono::seconds(1));
         }
     }
     
@@ -8,10 +8,12 @@
 #include "randomq_miner.h"
 #include "rpc_client.h"
 #include "config.h"
+#include "control_server.h"
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <chrono>
 
 class Miner {
@@ -28,19 +30,67 @@ public:
     // Stop mining
     void stop();
     
+    // Block until SIGINT, SIGTERM or a stop request, then stop mining
+    void waitForStop();
+    
     // Check if running
     bool isRunning() const { return m_running; }
     
+    // Check if --benchmark was given
+    bool isBenchmark() const { return m_config.benchmark; }
+    
+    // Hash generated work offline at 1..N threads and print the scaling report
+    bool runBenchmark();
+    
+    // Check if --autotune was given
+    bool isAutotune() const { return m_config.autotune; }
+    
+    // Time candidate settings on generated work and save the fastest configuration
+    bool runAutotune();
+    
     // Get statistics
     void printStats() const;
     
-    // Signal handlers
-    static void signalHandler(int signal);
-    
 private:
+    // Take SIGINT, SIGTERM and SIGHUP synchronously and wake the waiting threads
+    void signalThread();
+    
+    // Wake threads waiting on m_wake_cv after a stop or reload request
+    void wake();
+    
+    // Sleep up to timeout, returning early on a stop or reload request
+    void waitFor(std::chrono::steady_clock::duration timeout);
+    
     // Initialize components
     bool initializeComponents();
     
+    // Apply thread, kernel and batch settings from m_config to the RandomQ miner
+    void configureRandomQMiner();
+    
+    // Thread count after the one-per-physical-core limit when SMT is off
+    int applySmtLimit(int count);
+    
+    // Upper bound for thread counts set while mining
+    int maxThreadCount() const;
+    
+    // Search kernel, nonce batch and thread count; stores the fastest in tuned
+    bool autotune(MinerConfig& tuned);
+    
+    // Key for the tuning cache: hardware fingerprint plus round count
+    std::string tuningFingerprint() const;
+    
+    // Hash generated work with the current miner settings for one benchmark step
+    double measureHashRate(int threads);
+    
+    // Re-read the --config file and apply the settings that can change while mining
+    bool reloadConfig();
+    
+    // Answer one command from the control socket; never throws
+    std::string handleControl(const std::string& command);
+    
+    // handleControl() without the exception guard
+    std::string runControlCommand(const std::string& command);
+    
     // Main mining loop
     void miningLoop();
     
@@ -60,6 +110,7 @@ private:
     // Components
     std::unique_ptr<RandomQMiner> m_randomq_miner;
     std::unique_ptr<RPCClient> m_rpc_client;
+    ControlServer m_control;
     
     // State
     std::atomic<bool> m_running;
@@ -68,6 +119,15 @@ private:
     // Threading
     std::thread m_main_thread;
     std::thread m_stats_thread;
+    std::thread m_signal_thread;
+    std::atomic<bool> m_signal_exit;
+    
+    // Waits in the mining loop, stats thread, benchmark and waitForStop()
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+    
+    // Orders runtime changes from SIGHUP reloads and the control socket
+    std::mutex m_config_mutex;
     
     // Statistics
     mutable std::mutex m_stats_mutex;
@@ -81,8 +141,9 @@ private:
     bool m_show_stats;
     uint32_t m_stats_interval;
     
-    // Signal handling
+    // Requests from the signal thread
     static std::atomic<bool> s_should_stop;
+    static std::atomic<bool> s_reload;
 };
 
 #endif // CPUMINER_MINER_H
@@ -0,0 +1,101 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_MPSC_QUEUE_H
+#define CPUMINER_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * Bounded lock-free queue for many producers and one consumer, after
+ * Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence number:
+ * a producer claims a cell with one compare-and-swap on the tail and
+ * publishes it by advancing the cell's sequence, so producers never wait
+ * for each other or for the consumer. TryPush() fails when the queue is
+ * full rather than blocking.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity)
+        : m_mask(RoundUp(capacity) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+    {
+        for (size_t i = 0; i <= m_mask; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    
+    // Add value from any thread; false if the queue is full
+    bool TryPush(T value) {
+        uint64_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence - pos);
+            if (diff == 0) {
+                // The cell is free for this position; claim it
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The consumer has not emptied this cell since the last lap
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Take the oldest value; consumer thread only. False if nothing is ready.
+    bool TryPop(T& value) {
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != m_head + 1) {
+            return false;
+        }
+        value = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        m_head++;
+        return true;
+    }
+    
+    size_t Capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+    
+    static size_t RoundUp(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+    
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    
+    // Producers share the tail; the head is the consumer's alone. Separate
+    // cache lines keep pushes from invalidating the consumer's line.
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    alignas(64) uint64_t m_head = 0;
+};
+
+#endif // CPUMINER_MPSC_QUEUE_H
@@ -8,6 +8,7 @@
 
 CRandomQHash::CRandomQHash()
     : m_initialized(false)
+    , m_has_midstate(false)
     , m_rounds(8192)
     , m_nonce(0)
 {
@@ -62,6 +63,7 @@ uint256 CRandomQHash::GetHash() {
 void CRandomQHash::Reset() {
     m_randomq.Reset();
     m_initialized = false;
+    m_has_midstate = false;
 }
 
 void CRandomQHash::SetRandomQRounds(uint64_t rounds) {
@@ -78,6 +80,38 @@ void CRandomQHash::SetRandomQNonce(uint64_t nonce) {
     }
 }
 
+void CRandomQHash::SetMidstate(const unsigned char* prefix, size_t len) {
+    Reset();
+    Initialize();
+    Write(prefix, len);
+    
+    // Snapshot the absorbed state; every nonce starts from this copy
+    m_midstate = m_randomq;
+    m_has_midstate = true;
+}
+
+void CRandomQHash::FinalizeFromMidstate(uint32_t nonce, unsigned char hash[OUTPUT_SIZE]) const {
+    unsigned char nonce_le[4] = {
+        static_cast<unsigned char>(nonce & 0xFF),
+        static_cast<unsigned char>((nonce >> 8) & 0xFF),
+        static_cast<unsigned char>((nonce >> 16) & 0xFF),
+        static_cast<unsigned char>((nonce >> 24) & 0xFF)
+    };
+    
+    CRandomQ lane = m_midstate;
+    lane.Write(std::span<const unsigned char>(nonce_le, sizeof(nonce_le)));
+    lane.Finalize(hash);
+}
+
+uint256 CRandomQHash::GetHashFromMidstate(uint32_t nonce) const {
+    unsigned char hash[OUTPUT_SIZE];
+    FinalizeFromMidstate(nonce, hash);
+    
+    uint256 result;
+    std::memcpy(result.begin(), hash, OUTPUT_SIZE);
+    return result;
+}
+
 // RandomQMining namespace implementation
 namespace RandomQMining {
 
@@ -87,35 +121,23 @@ uint256 CalculateRandomQHash(const std::vector<unsigned char>& header) {
     return hasher.GetHash();
 }
 
-uint256 CalculateRandomQHashOptimized(const std::vector<unsigned char>& header, uint32_t nonce) {
+uint256 CalculateRandomQHash(std::span<const unsigned char, CRandomQHash::HEADER_SIZE> header) {
     CRandomQHash hasher;
-    hasher.SetRandomQNonce(nonce);
-    hasher.Write(header);
-    return hasher.GetHash();
-}
-
-bool CheckTarget(const uint256& hash, const uint256& target) {
-    return hash < target;
+    return CalculateRandomQHash(hasher, header);
 }
 
-uint256 DifficultyToTarget(uint32_t difficulty) {
-    if (difficulty == 0) {
-        return uint256();
-    }
-    
-    // Convert difficulty to target
-    // Target = 2^256 / difficulty
-    uint256 max_target = uint256("0x00000000ffff0000000000000000000000000000000000000000000000000000");
-    return max_target / difficulty;
+uint256 CalculateRandomQHash(CRandomQHash& hasher, std::span<const unsigned char, CRandomQHash::HEADER_SIZE> header) {
+    // Reset keeps the configured rounds and nonce
+    hasher.Reset();
+    hasher.Write(header.data(), header.size());
+    return hasher.GetHash();
 }
 
-uint32_t TargetToDifficulty(const uint256& target) {
-    if (target == uint256()) {
-        return 0;
-    }
-    
-    uint256 max_target = uint256("0x00000000ffff0000000000000000000000000000000000000000000000000000");
-    return static_cast<uint32_t>((max_target / target).GetLow64());
+uint256 CalculateRandomQHashOptimized(const std::vector<unsigned char>& header, uint32_t nonce) {
+    CRandomQHash hasher;
+    hasher.SetRandomQNonce(nonce);
+    hasher.Write(header);
+    return hasher.GetHash();
 }
 
 } // namespace RandomQMining
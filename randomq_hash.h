@@ -6,6 +6,8 @@
 #define CPUMINER_RANDOMQ_HASH_H
 
 #include <cstdint>
+#include <array>
+#include <span>
 #include <vector>
 #include <string>
 #include "../src/uint256.h"
@@ -17,6 +19,8 @@
 class CRandomQHash {
 public:
     static const size_t OUTPUT_SIZE = 32; // 256-bit output
+    static const size_t HEADER_SIZE = 80; // Serialized block header
+    static const size_t HEADER_PREFIX_SIZE = 76; // Header without nNonce
     
     CRandomQHash();
     ~CRandomQHash();
@@ -46,33 +50,47 @@ public:
     void SetRandomQRounds(uint64_t rounds);
     void SetRandomQNonce(uint64_t nonce);
     
+    // Absorb the nonce-invariant header prefix and save the state as midstate
+    void SetMidstate(const unsigned char* prefix, size_t len);
+    
+    // Check if a midstate has been saved
+    bool HasMidstate() const { return m_has_midstate; }
+    
+    // Clone the midstate, absorb the little-endian nonce and finalize
+    void FinalizeFromMidstate(uint32_t nonce, unsigned char hash[OUTPUT_SIZE]) const;
+    
+    // Get hash for a nonce from the midstate as uint256
+    uint256 GetHashFromMidstate(uint32_t nonce) const;
+    
     // Get current state
     const uint64_t* GetState() const { return m_randomq.GetState(); }
     size_t GetStateSize() const { return 25; } // 25 x 64-bit words
     
 private:
     CRandomQ m_randomq;
+    CRandomQ m_midstate;
     bool m_initialized;
+    bool m_has_midstate;
     uint64_t m_rounds;
     uint64_t m_nonce;
 };
 
+// Serialized block header, kept on the stack instead of in a std::vector
+typedef std::array<unsigned char, CRandomQHash::HEADER_SIZE> HeaderBytes;
+
 // Utility functions for RandomQ mining
 namespace RandomQMining {
     // Calculate RandomQ hash for a block header
     uint256 CalculateRandomQHash(const std::vector<unsigned char>& header);
     
-    // Calculate RandomQ hash with optimizations
-    uint256 CalculateRandomQHashOptimized(const std::vector<unsigned char>& header, uint32_t nonce);
-    
-    // Check if a hash meets the target
-    bool CheckTarget(const uint256& hash, const uint256& target);
+    // Calculate RandomQ hash for a serialized 80-byte header
+    uint256 CalculateRandomQHash(std::span<const unsigned char, CRandomQHash::HEADER_SIZE> header);
     
-    // Convert difficulty to target
-    uint256 DifficultyToTarget(uint32_t difficulty);
+    // Same, resetting a caller-owned hasher instead of constructing a new one
+    uint256 CalculateRandomQHash(CRandomQHash& hasher, std::span<const unsigned char, CRandomQHash::HEADER_SIZE> header);
     
-    // Convert target to difficulty
-    uint32_t TargetToDifficulty(const uint256& target);
+    // Calculate RandomQ hash with optimizations
+    uint256 CalculateRandomQHashOptimized(const std::vector<unsigned char>& header, uint32_t nonce);
 }
 
 #endif // CPUMINER_RANDOMQ_HASH_H
@@ -0,0 +1,143 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "randomq_kernel.h"
+#include "randomq_hash.h"
+#include "cpu_info.h"
+#include "sha256.h"
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+namespace RandomQKernel {
+
+namespace {
+
+void HashLanes_Generic(const CRandomQHash& midstate, const uint32_t* nonces, uint256* out, size_t lanes) {
+    if (lanes > MAX_LANES) {
+        lanes = MAX_LANES;
+    }
+    
+    // Every lane is finalized from the same midstate, one after another
+    unsigned char hash[CRandomQHash::OUTPUT_SIZE];
+    for (size_t i = 0; i < lanes; i++) {
+        midstate.FinalizeFromMidstate(nonces[i], hash);
+        std::memcpy(out[i].begin(), hash, sizeof(hash));
+    }
+}
+
+uint32_t FilterLanes_Generic(const uint256* hashes, size_t lanes, uint64_t target_top) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < lanes && i < MAX_LANES; i++) {
+        mask |= static_cast<uint32_t>(CompiledTarget::TopWord(hashes[i]) <= target_top) << i;
+    }
+    return mask;
+}
+
+// Every kernel compiled in, narrowest first; Select() takes the last usable one
+const Kernel KERNELS[] = {
+    {"generic", Isa::GENERIC, 1, HashLanes_Generic, FilterLanes_Generic},
+};
+
+std::atomic<const Kernel*> g_active_kernel{nullptr};
+
+// Indexed by position in GetKernels(), one slot per entry of KERNELS
+std::atomic<bool> g_disabled[std::size(KERNELS)];
+
+} // namespace
+
+const std::vector<Kernel>& GetKernels() {
+    static const std::vector<Kernel> kernels(std::begin(KERNELS), std::end(KERNELS));
+    return kernels;
+}
+
+const Kernel* Find(const std::string& name) {
+    for (const Kernel& kernel : GetKernels()) {
+        if (name == kernel.name) {
+            return &kernel;
+        }
+    }
+    return nullptr;
+}
+
+bool IsSupported(const Kernel& kernel) {
+    const CPUFeatures& features = CPUInfo::GetFeatures();
+    switch (kernel.isa) {
+    case Isa::GENERIC:
+        return true;
+    case Isa::SSE41:
+        return features.sse41;
+    case Isa::AVX2:
+        return features.avx2;
+    case Isa::AVX512:
+        return features.avx512f;
+    }
+    return false;
+}
+
+bool IsAllowed(const Kernel& kernel, bool avx2, bool sse4) {
+    switch (kernel.isa) {
+    case Isa::GENERIC:
+        return true;
+    case Isa::SSE41:
+        return sse4;
+    case Isa::AVX2:
+    case Isa::AVX512:
+        return avx2;
+    }
+    return false;
+}
+
+const Kernel& Select(bool avx2, bool sse4) {
+    // Pick the SHA256 transform before any hashing starts
+    Sha256Implementation();
+    
+    // Kernels are listed from the generic fallback, which always qualifies,
+    // up to the widest instruction set; no timing is needed to choose
+    const Kernel* best = &GetKernels().front();
+    for (const Kernel& kernel : GetKernels()) {
+        if (IsSupported(kernel) && IsAllowed(kernel, avx2, sse4) && !IsDisabled(kernel)) {
+            best = &kernel;
+        }
+    }
+    
+    Activate(*best);
+    return *best;
+}
+
+bool Disable(const Kernel& kernel) {
+    if (kernel.isa == Isa::GENERIC) {
+        return false;
+    }
+    return !g_disabled[&kernel - GetKernels().data()].exchange(true);
+}
+
+bool IsDisabled(const Kernel& kernel) {
+    return g_disabled[&kernel - GetKernels().data()].load();
+}
+
+void Activate(const Kernel& kernel) {
+    g_active_kernel.store(&kernel, std::memory_order_release);
+}
+
+const Kernel& Active() {
+    const Kernel* kernel = g_active_kernel.load(std::memory_order_acquire);
+    return kernel ? *kernel : GetKernels().front();
+}
+
+const std::string& Sha256Implementation() {
+    // Installs the fastest SHA256 transform (SHA-NI, AVX2, SSE4.1 or generic)
+    static const std::string implementation = SHA256AutoDetect();
+    return implementation;
+}
+
+void HashLanes(const CRandomQHash& midstate, const uint32_t* nonces, uint256* out, size_t lanes) {
+    Active().hash_lanes(midstate, nonces, out, lanes);
+}
+
+uint32_t FilterLanes(const uint256* hashes, size_t lanes, const CompiledTarget& target) {
+    return Active().filter_lanes(hashes, lanes, target.words[3]);
+}
+
+} // namespace RandomQKernel
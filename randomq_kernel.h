@@ -0,0 +1,94 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_RANDOMQ_KERNEL_H
+#define CPUMINER_RANDOMQ_KERNEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "uint256.h"
+#include "randomq_target.h"
+
+// Forward declarations
+class CRandomQHash;
+
+/**
+ * Multi-lane RandomQ hashing: several nonces share one job midstate and
+ * are hashed together in a single call.
+ *
+ * Only the generic kernel is built. A kernel for an instruction set has to
+ * run several lanes' 25-word states through the RandomQ rounds together,
+ * and that round loop is CRandomQ in src/crypto/randomq.cpp, outside this
+ * tree. Built with the same scalar round loop, per-ISA objects would only
+ * differ in compiler flags. The registry below is where such kernels plug
+ * in, each gated on cpuid and the enable_avx2/enable_sse4 settings.
+ */
+namespace RandomQKernel {
+    // Maximum number of nonces hashed per call
+    static const size_t MAX_LANES = 8;
+    
+    typedef void (*HashLanesFn)(const CRandomQHash& midstate, const uint32_t* nonces, uint256* out, size_t lanes);
+    
+    // Bitmask of lanes whose most significant hash word is <= target_top
+    typedef uint32_t (*FilterLanesFn)(const uint256* hashes, size_t lanes, uint64_t target_top);
+    
+    // Instruction set a kernel object was compiled for
+    enum class Isa {
+        GENERIC,
+        SSE41,
+        AVX2,
+        AVX512
+    };
+    
+    struct Kernel {
+        const char* name;
+        Isa isa;
+        size_t lanes;           // Nonces per call
+        HashLanesFn hash_lanes;
+        FilterLanesFn filter_lanes;
+    };
+    
+    // All kernels compiled into this binary
+    const std::vector<Kernel>& GetKernels();
+    
+    // Kernel with the given name, or nullptr if none was compiled in
+    const Kernel* Find(const std::string& name);
+    
+    // Check if this CPU can run a kernel
+    bool IsSupported(const Kernel& kernel);
+    
+    // Check if the enable_avx2/enable_sse4 settings allow a kernel
+    bool IsAllowed(const Kernel& kernel, bool avx2, bool sse4);
+    
+    // Pick and activate the widest usable kernel that is not disabled
+    const Kernel& Select(bool avx2, bool sse4);
+    
+    // Stop using a kernel that returned a wrong hash; Select() skips it from
+    // then on. The generic kernel is the last fallback and is never disabled.
+    // Returns true only for the call that disabled it.
+    bool Disable(const Kernel& kernel);
+    
+    // Check if a kernel has been disabled
+    bool IsDisabled(const Kernel& kernel);
+    
+    // Make a specific kernel active; the caller checks IsSupported() first
+    void Activate(const Kernel& kernel);
+    
+    // Currently active kernel
+    const Kernel& Active();
+    
+    // Name of the SHA256 implementation picked by SHA256AutoDetect()
+    const std::string& Sha256Implementation();
+    
+    // Hash nonces[0..lanes) from the midstate into out[0..lanes) with the active kernel
+    void HashLanes(const CRandomQHash& midstate, const uint32_t* nonces, uint256* out, size_t lanes);
+    
+    // Bitmask of lanes that may meet the target, from one compare of the top words.
+    // Candidates still need CompiledTarget::Check() for the full 256-bit compare.
+    uint32_t FilterLanes(const uint256* hashes, size_t lanes, const CompiledTarget& target);
+}
+
+#endif // CPUMINER_RANDOMQ_KERNEL_H
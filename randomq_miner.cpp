@@ -9,12 +9,58 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <cstdint>
 
 // Include RandomQ implementation
+#include "cpu_info.h"
 #include "randomq_hash.h"
+#include "randomq_kernel.h"
 #include "randomq_mining.h"
+#include "randomq_target.h"
+
+namespace {
+
+// Nonce leases are sized to take about this long at the thread's measured rate
+const std::chrono::milliseconds LEASE_TIME(10);
+const uint64_t MAX_LEASE = 1 << 20;
+
+// Candidates waiting for the submitter; more than this in flight means it is
+// stuck, and further candidates are counted as dropped
+const size_t SOLUTION_QUEUE_SIZE = 1024;
+
+// Interval between hash counter samples for the windowed rates
+const std::chrono::seconds SAMPLE_INTERVAL(1);
+
+// Hash one kernel call of a throwaway job, faulting in the stack, code and
+// TLB entries a thread hashes with before its first real job arrives
+void WarmUp() {
+    RandomQMining::HashJob job;
+    RandomQMining::PrepareJob(job, CBlockHeader(), 1);
+    RandomQMining::HashRange(job, 0, RandomQKernel::Active().lanes, CompiledTarget::FromTarget(uint256()),
+                             [](uint32_t, const uint256&) { return false; });
+}
+
+} // namespace
+
+// Everything the mining threads need for one job, prepared once in setWork()
+// and never modified after it is published
+struct RandomQMiner::Job {
+    uint64_t generation;
+    std::chrono::steady_clock::time_point published;
+    std::shared_ptr<const WorkData> work;
+    RandomQMining::HashJob hash;    // Header and prefix midstate
+    CompiledTarget target;
+    uint32_t base_version;          // Template version that rolling started from
+    bool rolled;                    // Extended locally rather than received
+    
+    // Offset of the next unleased nonce; the only field threads modify
+    alignas(64) mutable std::atomic<uint64_t> cursor{0};
+    
+    // Rolled successor, prepared while the last lease of this job is hashed
+    mutable std::atomic<std::shared_ptr<Job>> next;
+};
 
 RandomQMiner::RandomQMiner()
     : m_num_threads(0)
@@ -23,12 +69,22 @@ RandomQMiner::RandomQMiner()
     , m_enable_sse4(true)
     , m_enable_optimized(true)
     , m_submit_work(true)
+    , m_kernel_name("auto")
+    , m_nonce_batch(256)
+    , m_verify_sample(100000)
+    , m_version_mask(0x1fffe000)
+    , m_ntime_roll(600)
+    , m_affinity("cores")
+    , m_active_threads(0)
     , m_running(false)
     , m_should_stop(false)
-    , m_has_work(false)
+    , m_wakeups(0)
+    , m_solutions(SOLUTION_QUEUE_SIZE)
+    , m_solution_wakeups(0)
+    , m_submit_stop(false)
+    , m_work_requested(0)
+    , m_job_generation(0)
     , m_log_level(2)
-    , m_show_stats(true)
-    , m_stats_interval(10)
 {
     m_stats.reset();
 }
@@ -58,11 +114,15 @@ bool RandomQMiner::initialize(const std::string& config_file) {
     m_enable_sse4 = config.enable_sse4;
     m_enable_optimized = config.enable_optimized;
     m_submit_work = config.submit_work;
+    m_kernel_name = config.kernel;
+    m_nonce_batch = config.nonce_batch;
+    m_verify_sample = config.verify_sample;
+    m_version_mask = config.version_mask;
+    m_ntime_roll = config.ntime_roll;
+    m_affinity = config.affinity;
     m_log_level = config.log_level;
-    m_show_stats = config.show_stats;
-    m_stats_interval = config.stats_interval;
     
-    log(2, "RandomQMiner initialized with " + std::to_string(m_num_threads) + " threads");
+    log(2, "RandomQMiner initialized with " + std::to_string(m_num_threads.load()) + " threads");
     log(2, "RandomQ rounds: " + std::to_string(m_randomq_rounds));
     log(2, "AVX2: " + std::string(m_enable_avx2 ? "enabled" : "disabled"));
     log(2, "SSE4: " + std::string(m_enable_sse4 ? "enabled" : "disabled"));
@@ -77,18 +137,53 @@ void RandomQMiner::start() {
         return;
     }
     
+    // Pick the hashing kernel for this CPU before any thread starts
+    const RandomQKernel::Kernel* forced = nullptr;
+    if (m_kernel_name != "auto") {
+        forced = RandomQKernel::Find(m_kernel_name);
+        if (!forced || !RandomQKernel::IsSupported(*forced)) {
+            log(1, "Kernel " + m_kernel_name + " is not available on this CPU, selecting automatically");
+            forced = nullptr;
+        }
+    }
+    if (forced && RandomQKernel::IsDisabled(*forced)) {
+        log(1, "Kernel " + m_kernel_name + " was disabled after a wrong hash, selecting automatically");
+        forced = nullptr;
+    }
+    if (forced) {
+        // Activate() does not install the SHA256 transform that Select() would
+        RandomQKernel::Sha256Implementation();
+        RandomQKernel::Activate(*forced);
+    }
+    const RandomQKernel::Kernel& kernel = forced ? *forced : RandomQKernel::Select(m_enable_avx2, m_enable_sse4);
+    log(2, "CPU features: " + CPUInfo::FeatureString());
+    log(2, "RandomQ kernel: " + std::string(kernel.name) + " (" + std::to_string(kernel.lanes) + " lanes)");
+    log(2, "SHA256 implementation: " + RandomQKernel::Sha256Implementation());
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.kernel = kernel.name;
+        m_stats.sha256_impl = RandomQKernel::Sha256Implementation();
+    }
+    
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
     m_running = true;
     m_should_stop = false;
     m_start_time = std::chrono::steady_clock::now();
-    m_last_stats_time = m_start_time;
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_meter.Reset();
+        m_thread_meters.clear();
+    }
+    
+    // The submitter runs before any thread can find a candidate
+    m_submit_stop = false;
+    m_submit_thread = std::thread(&RandomQMiner::submitThread, this);
     
     // Start mining threads
     m_threads.clear();
-    for (int i = 0; i < m_num_threads; i++) {
-        m_threads.emplace_back(&RandomQMiner::miningThread, this, i);
-    }
-    
-    log(2, "Started " + std::to_string(m_num_threads) + " mining threads");
+    resizePool(m_num_threads);
+    m_sample_thread = std::thread(&RandomQMiner::sampleThread, this);
 }
 
 void RandomQMiner::stop() {
@@ -97,7 +192,15 @@ void RandomQMiner::stop() {
     }
     
     log(2, "Stopping miner...");
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
     m_should_stop = true;
+    wakeThreads();
+    {
+        // Taking the lock orders the flag before the sampler's next wait
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+    }
+    m_sample_cv.notify_all();
+    m_sample_thread.join();
     
     // Wait for all threads to finish
     for (auto& thread : m_threads) {
@@ -107,43 +210,254 @@ void RandomQMiner::stop() {
     }
     
     m_threads.clear();
+    m_active_threads = 0;
+    
+    // Every candidate is queued by now; the submitter drains them and exits
+    m_submit_stop = true;
+    m_solution_wakeups.fetch_add(1, std::memory_order_release);
+    m_solution_wakeups.notify_one();
+    m_submit_thread.join();
     m_running = false;
     
+    // Fold the exited threads' counters into the totals
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        for (const std::unique_ptr<ThreadCounters>& counters : m_counters) {
+            if (counters) {
+                m_stats.total_hashes += counters->hashes.load(std::memory_order_relaxed);
+                m_stats.candidates += counters->candidates.load(std::memory_order_relaxed);
+            }
+        }
+        m_counters.clear();
+    }
+    
     log(2, "Miner stopped");
 }
 
 MiningStats RandomQMiner::getStats() const {
+    MiningStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        stats = m_stats;
+        for (const std::unique_ptr<ThreadCounters>& counters : m_counters) {
+            if (counters) {
+                stats.total_hashes += counters->hashes.load(std::memory_order_relaxed);
+                stats.candidates += counters->candidates.load(std::memory_order_relaxed);
+            }
+        }
+        stats.rates = RandomQMining::MiningUtils::CalculateHashRate(m_meter);
+    }
+    
+    stats.elapsed_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+    stats.hash_rate = RandomQMining::MiningUtils::CalculateHashRate(stats.total_hashes, stats.elapsed_time);
+    return stats;
+}
+
+std::vector<ThreadStats> RandomQMiner::getThreadStats() const {
+    std::vector<ThreadStats> threads;
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
     std::lock_guard<std::mutex> lock(m_stats_mutex);
-    return m_stats;
+    for (size_t i = 0; i < m_counters.size(); i++) {
+        ThreadStats thread{0, 0, 0, 0.0, RandomQMining::MiningUtils::CalculateHashRate(m_thread_meters[i])};
+        
+        // A thread that has not started yet has no counters
+        const ThreadCounters* counters = m_counters[i].get();
+        if (counters) {
+            int64_t last_batch = counters->last_batch.load(std::memory_order_relaxed);
+            thread.hashes = counters->hashes.load(std::memory_order_relaxed);
+            thread.candidates = counters->candidates.load(std::memory_order_relaxed);
+            thread.job = counters->job.load(std::memory_order_relaxed);
+            thread.seconds_since_batch = last_batch > 0 ? std::chrono::duration<double>(std::chrono::steady_clock::duration(now - last_batch)).count() : 0.0;
+        }
+        threads.push_back(thread);
+    }
+    return threads;
 }
 
 void RandomQMiner::setWork(const WorkData& work) {
-    if (!work.isValid()) {
+    setWork(std::make_shared<const WorkData>(work));
+}
+
+void RandomQMiner::setWork(std::shared_ptr<const WorkData> work) {
+    if (!work || !work->isValid() || !checkWork(*work)) {
         log(0, "Invalid work data received");
         return;
     }
     
+    const uint32_t base_version = work->version;
+    const uint32_t bits = work->bits;
+    std::shared_ptr<Job> job = makeJob(std::move(work), base_version, false);
+    if (!job) {
+        std::ostringstream oss;
+        oss << "Invalid work data received: nBits 0x" << std::hex << bits << " is negative, overflows or is zero";
+        log(0, oss.str());
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_work_mutex);
+        publishJob(job);
+    }
+    
+    log(2, "New work received (job " + std::to_string(job->generation) + "):");
+    job->work->print();
+}
+
+std::shared_ptr<RandomQMiner::Job> RandomQMiner::makeJob(std::shared_ptr<const WorkData> work, uint32_t base_version, bool rolled) {
+    // Absorb the header prefix and decode the target once for all threads
+    auto job = std::make_shared<Job>();
+    job->work = std::move(work);
+    if (!CompiledTarget::FromWork(job->work->target, job->work->bits, job->target)) {
+        return nullptr;
+    }
+    prepareWork(*job->work, job->hash);
+    job->base_version = base_version;
+    job->rolled = rolled;
+    return job;
+}
+
+std::shared_ptr<RandomQMiner::Job> RandomQMiner::makeRolledJob(const Job& job) {
+    // Only what both the settings and the template permit is rolled. nTime
+    // may run ahead of the wall clock by at most m_ntime_roll seconds and
+    // never past the template's maxtime.
+    const WorkData& base = *job.work;
+    uint32_t mask = m_version_mask & base.version_mask;
+    uint32_t time_limit = base.timestamp;
+    if (base.time_mutable) {
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        time_limit = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count()) + m_ntime_roll;
+        if (base.max_time != 0) {
+            time_limit = std::min(time_limit, base.max_time);
+        }
+    }
+    
+    auto work = std::make_shared<WorkData>(base);
+    if (!RandomQMining::RollHeader(work->version, work->timestamp, job.base_version, mask, time_limit)) {
+        return nullptr;
+    }
+    return makeJob(std::move(work), job.base_version, true);
+}
+
+void RandomQMiner::publishJob(const std::shared_ptr<Job>& job) {
+    // Called with m_work_mutex held, so generations are published in order
+    job->generation = m_job_generation.load(std::memory_order_relaxed) + 1;
+    job->published = std::chrono::steady_clock::now();
+    m_job.store(job, std::memory_order_release);
+    m_job_generation.store(job->generation, std::memory_order_release);
+    wakeThreads();
+}
+
+bool RandomQMiner::rollJob(const std::shared_ptr<const Job>& current) {
+    std::shared_ptr<Job> next = current->next.load(std::memory_order_acquire);
+    if (!next) {
+        next = makeRolledJob(*current);
+    }
+    
     std::lock_guard<std::mutex> lock(m_work_mutex);
-    m_current_work = work;
-    m_has_work = true;
+    if (m_job.load(std::memory_order_acquire) != current) {
+        // Another thread rolled first, or new work arrived
+        return true;
+    }
+    if (!next) {
+        return false;
+    }
+    publishJob(next);
     
-    log(2, "New work received:");
-    work.print();
+    std::ostringstream oss;
+    oss << "Nonce range exhausted, rolled to version 0x" << std::hex << next->work->version << std::dec
+        << ", time " << next->work->timestamp << " (job " << next->generation << ")";
+    log(3, oss.str());
+    return true;
+}
+
+void RandomQMiner::clearWork() {
+    std::lock_guard<std::mutex> lock(m_work_mutex);
+    m_job.store(nullptr, std::memory_order_release);
+    m_job_generation.fetch_add(1, std::memory_order_release);
+    wakeThreads();
 }
 
 void RandomQMiner::setThreadCount(int count) {
-    if (m_running) {
-        log(1, "Cannot change thread count while mining");
+    if (count <= 0) {
+        log(1, "Thread count must be at least 1");
         return;
     }
     
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    if (m_running) {
+        resizePool(count);
+        return;
+    }
     m_num_threads = count;
     log(2, "Thread count set to " + std::to_string(count));
 }
 
+void RandomQMiner::resizePool(int count) {
+    const int running = static_cast<int>(m_threads.size());
+    if (count < running) {
+        // Retiring threads finish their lease, so no leased nonces are skipped
+        m_active_threads.store(count, std::memory_order_relaxed);
+        wakeThreads();
+        for (int i = count; i < running; i++) {
+            m_threads[i].join();
+        }
+        m_threads.erase(m_threads.begin() + count, m_threads.end());
+        m_num_threads = count;
+        
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        for (int i = count; i < running; i++) {
+            if (m_counters[i]) {
+                m_stats.total_hashes += m_counters[i]->hashes.load(std::memory_order_relaxed);
+                m_stats.candidates += m_counters[i]->candidates.load(std::memory_order_relaxed);
+            }
+        }
+        m_counters.resize(count);
+        m_thread_meters.resize(count);
+    } else if (count > running) {
+        // Placement for the whole pool; the existing threads' CPUs are a prefix of it
+        std::vector<unsigned int> cpus;
+        if (!CPUInfo::PlanAffinity(m_affinity, count, cpus)) {
+            log(1, "Invalid thread affinity " + m_affinity + ", leaving threads unpinned");
+            cpus.clear();
+        }
+        if (!cpus.empty()) {
+            std::string list;
+            for (int i = running; i < count; i++) {
+                list += (list.empty() ? "" : ",") + std::to_string(cpus[i]);
+            }
+            log(2, "Thread affinity " + m_affinity + ": CPUs " + list);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(m_stats_mutex);
+            m_counters.resize(count);
+            m_thread_meters.resize(count);
+        }
+        m_num_threads = count;
+        m_active_threads.store(count, std::memory_order_relaxed);
+        for (int i = running; i < count; i++) {
+            m_threads.emplace_back(&RandomQMiner::miningThread, this, i, cpus.empty() ? -1 : static_cast<int>(cpus[i]));
+        }
+    } else {
+        return;
+    }
+    
+    log(2, running == 0 ? "Started " + std::to_string(count) + " mining threads"
+                        : "Mining threads resized from " + std::to_string(running) + " to " + std::to_string(count));
+}
+
 void RandomQMiner::setRandomQRounds(uint64_t rounds) {
+    if (m_running) {
+        log(1, "Cannot change RandomQ rounds while mining");
+        return;
+    }
+    
     m_randomq_rounds = rounds;
     log(2, "RandomQ rounds set to " + std::to_string(rounds));
+    
+    // The published midstate was absorbed with the old round count
+    if (std::shared_ptr<const Job> job = m_job.load(std::memory_order_acquire)) {
+        setWork(job->work);
+    }
 }
 
 void RandomQMiner::setOptimizations(bool avx2, bool sse4, bool optimized) {
@@ -156,83 +470,302 @@ void RandomQMiner::setOptimizations(bool avx2, bool sse4, bool optimized) {
            ", Optimized: " + std::string(optimized ? "enabled" : "disabled"));
 }
 
-void RandomQMiner::miningThread(int thread_id) {
-    log(3, "Mining thread " + std::to_string(thread_id) + " started");
+void RandomQMiner::setKernel(const std::string& name) {
+    if (m_running) {
+        log(1, "Cannot change kernel while mining");
+        return;
+    }
+    
+    m_kernel_name = name;
+    log(2, "Kernel set to " + name);
+}
+
+void RandomQMiner::setNonceBatch(uint32_t nonces) {
+    if (m_running) {
+        log(1, "Cannot change nonce batch while mining");
+        return;
+    }
+    
+    m_nonce_batch = nonces > 0 ? nonces : 1;
+    log(2, "Nonce batch set to " + std::to_string(m_nonce_batch));
+}
+
+void RandomQMiner::setVerifySample(uint64_t hashes) {
+    if (m_running) {
+        log(1, "Cannot change hash sampling while mining");
+        return;
+    }
     
-    uint32_t local_hashes = 0;
-    const uint32_t stats_update_interval = 10000; // Update stats every 10k hashes
+    m_verify_sample = hashes;
+    log(2, hashes > 0 ? "Verifying 1 in " + std::to_string(hashes) + " hashes" : std::string("Hash sampling disabled"));
+}
+
+void RandomQMiner::setRolling(uint32_t version_mask, uint32_t ntime_roll) {
+    if (m_running) {
+        log(1, "Cannot change header rolling while mining");
+        return;
+    }
     
+    m_version_mask = version_mask;
+    m_ntime_roll = ntime_roll;
+}
+
+void RandomQMiner::wakeThreads() {
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    m_wakeups.notify_all();
+}
+
+void RandomQMiner::sampleThread() {
+    std::unique_lock<std::mutex> lock(m_stats_mutex);
     while (!m_should_stop) {
-        // Get current work
-        WorkData work;
-        bool has_work = false;
-        
-        {
-            std::lock_guard<std::mutex> lock(m_work_mutex);
-            if (m_has_work) {
-                work = m_current_work;
-                has_work = true;
-            }
+        // Retired threads' hashes are in m_stats, so the total never drops on a resize
+        auto now = std::chrono::steady_clock::now();
+        uint64_t total = m_stats.total_hashes;
+        for (size_t i = 0; i < m_counters.size(); i++) {
+            uint64_t hashes = m_counters[i] ? m_counters[i]->hashes.load(std::memory_order_relaxed) : 0;
+            m_thread_meters[i].Sample(now, hashes);
+            total += hashes;
         }
-        
-        if (!has_work) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        m_meter.Sample(now, total);
+        m_sample_cv.wait_for(lock, SAMPLE_INTERVAL, [this] { return m_should_stop.load(); });
+    }
+}
+
+void RandomQMiner::setWorkRequest(std::function<void()> callback) {
+    if (m_running) {
+        log(1, "Cannot change the work request callback while mining");
+        return;
+    }
+    
+    m_work_request = std::move(callback);
+}
+
+void RandomQMiner::setAffinity(const std::string& policy) {
+    if (m_running) {
+        log(1, "Cannot change thread affinity while mining");
+        return;
+    }
+    
+    m_affinity = policy;
+    log(2, "Thread affinity set to " + policy);
+}
+
+void RandomQMiner::miningThread(int thread_id, int cpu) {
+    // Pin before this thread touches its stack or allocates, so first-touch
+    // places its hasher state and counters on the local NUMA node
+    if (cpu >= 0) {
+        if (!CPUInfo::PinThread(cpu)) {
+            log(1, "Could not pin mining thread " + std::to_string(thread_id) + " to CPU " + std::to_string(cpu));
+        }
+    }
+    log(3, "Mining thread " + std::to_string(thread_id) + " started");
+    
+    // This thread's counters; plain relaxed stores, nothing shared on the hot path
+    auto owned_counters = std::make_unique<ThreadCounters>();
+    ThreadCounters& counters = *owned_counters;
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_counters[thread_id] = std::move(owned_counters);
+    }
+    WarmUp();
+    uint64_t thread_hashes = 0;
+    const uint32_t hash_batch = m_nonce_batch; // Nonces per HashRange call and the first lease size
+    
+    // Generation of the last job whose nonce range this thread saw run out
+    uint64_t finished_generation = 0;
+    
+    // Nonces per lease, adapted to this thread's speed and kept across jobs
+    uint64_t lease_size = hash_batch;
+    
+    // Hashes left until the next sampled check; the sampled lane rotates
+    uint64_t until_sample = m_verify_sample;
+    size_t sample_lane = 0;
+    
+    // Set once setThreadCount() shrinks the pool below this thread
+    auto retired = [&] {
+        return thread_id >= m_active_threads.load(std::memory_order_relaxed);
+    };
+    
+    // The wakeup count is read before the stop and job checks, so an event
+    // between those checks and the wait below ends the wait at once
+    for (uint32_t wakeups = m_wakeups.load(std::memory_order_acquire); !m_should_stop && !retired();
+         wakeups = m_wakeups.load(std::memory_order_acquire)) {
+        // Not lock-free (see m_job), but taken only on a job switch or wakeup;
+        // the snapshot stays alive while this thread holds it
+        std::shared_ptr<const Job> current = m_job.load(std::memory_order_acquire);
+        if (!current || current->generation == finished_generation) {
+            m_wakeups.wait(wakeups, std::memory_order_acquire);
             continue;
         }
+        const WorkData& work = *current->work;
+        const RandomQMining::HashJob& job = current->hash;
+        const CompiledTarget& target = current->target;
+        counters.job.store(current->generation, std::memory_order_relaxed);
         
-        // Mining loop
-        uint32_t nonce = work.nonce_start + thread_id;
-        uint32_t nonce_increment = m_num_threads;
+        // Threads lease contiguous chunks of the range from the job's cursor
+        const uint64_t range = static_cast<uint64_t>(work.nonce_end) - work.nonce_start + 1;
+        bool exhausted = false;
+        
+        // A new job, clearWork() or stop() abandons this one before the next kernel call
+        auto stale = [&] {
+            return m_job_generation.load(std::memory_order_relaxed) != current->generation ||
+                   m_should_stop.load(std::memory_order_relaxed);
+        };
         
-        while (!m_should_stop && nonce <= work.nonce_end) {
-            // Calculate hash
-            uint256 hash = calculateHash(work, nonce);
-            local_hashes++;
+        // Mining loop
+        while (!stale() && !retired()) {
+            // One kernel per lease: every hash of the lease, and every fault
+            // blamed on it, comes from this kernel even if another thread
+            // disables it meanwhile
+            const RandomQKernel::Kernel& kernel = RandomQKernel::Active();
+            const uint64_t lanes = kernel.lanes;
             
-            // Check if hash meets target
-            if (checkWork(work) && hash < uint256(work.target)) {
-                log(2, "Found valid block! Nonce: " + std::to_string(nonce));
-                log(2, "Hash: " + hash.ToString());
-                
-                // Update statistics
-                {
+            // Candidates are verified and submitted by the submitter thread;
+            // this one carries on with its lease
+            auto on_solution = [&](uint32_t solution_nonce, const uint256& hash) {
+                counters.candidates.fetch_add(1, std::memory_order_relaxed);
+                if (m_solutions.TryPush({current, solution_nonce, hash, &kernel})) {
+                    m_solution_wakeups.fetch_add(1, std::memory_order_release);
+                    m_solution_wakeups.notify_one();
+                } else {
                     std::lock_guard<std::mutex> lock(m_stats_mutex);
-                    m_stats.valid_blocks++;
-                    m_stats.best_hash = hash.ToString();
-                    m_stats.best_nonce = nonce;
+                    m_stats.dropped_solutions++;
                 }
+                return true;
+            };
+            
+            // Shrink leases near the end of the range so threads run out together
+            uint64_t remaining = range - std::min(range, current->cursor.load(std::memory_order_relaxed));
+            uint64_t threads = std::max(m_num_threads.load(std::memory_order_relaxed), 1);
+            uint64_t lease = std::min(lease_size, std::max(lanes, remaining / (2 * threads)));
+            
+            uint64_t offset = current->cursor.fetch_add(lease, std::memory_order_relaxed);
+            if (offset >= range) {
+                exhausted = true;
+                break;
+            }
+            if (offset + lease >= range) {
+                // Exactly one thread takes the last lease; it prepares the rolled job meanwhile
+                current->next.store(makeRolledJob(*current), std::memory_order_release);
+            }
+            uint64_t nonce = work.nonce_start + offset;
+            const uint64_t lease_end = nonce + std::min(lease, range - offset);
+            const auto lease_start = std::chrono::steady_clock::now();
+            
+            while (nonce < lease_end && !stale()) {
+                uint64_t count = std::min<uint64_t>(hash_batch, lease_end - nonce);
+                uint64_t hashed = RandomQMining::HashRange(kernel, job, static_cast<uint32_t>(nonce), count, target, on_solution, stale);
                 
-                // Submit solution
-                if (m_submit_work) {
-                    submitSolution(work, nonce, hash);
+                // Sampled check of ordinary hashes from the batch just done
+                if (m_verify_sample > 0 && hashed >= until_sample) {
+                    verifyKernel(kernel, job, static_cast<uint32_t>(nonce), sample_lane++);
+                    until_sample = m_verify_sample;
+                } else if (m_verify_sample > 0) {
+                    until_sample -= hashed;
                 }
                 
-                // Update work (get new block template)
-                // This would typically be done by the RPC client
-                break;
+                nonce += hashed;
+                thread_hashes += hashed;
+                counters.hashes.store(thread_hashes, std::memory_order_relaxed);
+                counters.last_batch.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
             }
             
-            nonce += nonce_increment;
-            
-            // Update statistics periodically
-            if (local_hashes % stats_update_interval == 0) {
-                updateStats(local_hashes);
-                local_hashes = 0;
+            // Size the next full-size lease for LEASE_TIME at the speed this one ran at
+            auto elapsed = std::chrono::steady_clock::now() - lease_start;
+            if (nonce >= lease_end && lease == lease_size && elapsed.count() > 0) {
+                double rate = lease / std::chrono::duration<double>(elapsed).count();
+                uint64_t next = static_cast<uint64_t>(rate * std::chrono::duration<double>(LEASE_TIME).count());
+                lease_size = std::clamp<uint64_t>(next / lanes * lanes, lanes, MAX_LEASE);
             }
         }
         
-        // If we've exhausted the nonce range, wait for new work
-        if (nonce > work.nonce_end) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // The range ran out with no header variant left: wait for the next job
+        if (exhausted && !rollJob(current)) {
+            finished_generation = current->generation;
+            
+            // Ask for new work now rather than at the next template refresh
+            if (m_work_request && m_work_requested.exchange(current->generation) != current->generation) {
+                m_work_request();
+            }
+        } else if (!exhausted && !m_should_stop && !retired()) {
+            // Time from publishing the replacement work to leaving this job
+            std::shared_ptr<const Job> next = m_job.load(std::memory_order_acquire);
+            if (next && !next->rolled) {
+                recordStaleAbort(std::chrono::steady_clock::now() - next->published);
+            }
         }
     }
     
     log(3, "Mining thread " + std::to_string(thread_id) + " stopped");
 }
 
+void RandomQMiner::submitThread() {
+    while (true) {
+        // Read before draining, so a push after the last TryPop ends the wait
+        uint32_t wakeups = m_solution_wakeups.load(std::memory_order_acquire);
+        bool stopping = m_submit_stop.load(std::memory_order_acquire);
+        Solution solution;
+        while (m_solutions.TryPop(solution)) {
+            processSolution(solution);
+        }
+        if (stopping) {
+            break;
+        }
+        m_solution_wakeups.wait(wakeups, std::memory_order_acquire);
+    }
+}
+
+void RandomQMiner::processSolution(const Solution& solution) {
+    const Job& current = *solution.job;
+    const WorkData& work = *current.work;
+    
+    // Every candidate is re-hashed on the reference path before it is reported
+    uint256 reference = RandomQMining::ReferenceHash(current.hash, solution.nonce);
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.verified_hashes++;
+    }
+    if (reference != solution.hash) {
+        onKernelFault(*solution.kernel, solution.nonce, solution.hash, reference);
+        return;
+    }
+    
+    // The job's target may come from the target string; the block must also
+    // meet nBits. The reference hash above used the job's rounds, so it is
+    // checked directly rather than hashed again.
+    CompiledTarget bits_target;
+    if (work.bits != 0 && (!CompiledTarget::FromCompact(work.bits, bits_target) || !bits_target.Check(reference))) {
+        log(1, "Candidate nonce " + std::to_string(solution.nonce) + " fails the nBits target, not submitted");
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.invalid_blocks++;
+        return;
+    }
+    
+    log(2, "Found valid block! Nonce: " + std::to_string(solution.nonce));
+    log(2, "Hash: " + solution.hash.ToString());
+    
+    // Update statistics
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.valid_blocks++;
+        m_stats.best_hash = solution.hash.ToString();
+        m_stats.best_nonce = solution.nonce;
+    }
+    
+    // Submit solution
+    if (m_submit_work) {
+        submitSolution(work, solution.nonce, solution.hash);
+    }
+    
+    // The block is spent; ask for a new template once per job
+    if (m_work_request && m_work_requested.exchange(current.generation) != current.generation) {
+        m_work_request();
+    }
+}
+
 bool RandomQMiner::checkWork(const WorkData& work) {
-    // Basic validation
-    if (work.block_template.empty() || work.target.empty()) {
+    // Basic validation; the target may come from either the target string or nBits
+    if (work.block_template.empty() || (work.target.empty() && work.bits == 0)) {
         return false;
     }
     
@@ -240,7 +773,7 @@ bool RandomQMiner::checkWork(const WorkData& work) {
     return true;
 }
 
-uint256 RandomQMiner::calculateHash(const WorkData& work, uint32_t nonce) {
+void RandomQMiner::prepareWork(const WorkData& work, RandomQMining::HashJob& job) {
     // Create block header
     CBlockHeader header;
     header.nVersion = work.version;
@@ -248,10 +781,54 @@ uint256 RandomQMiner::calculateHash(const WorkData& work, uint32_t nonce) {
     header.hashMerkleRoot = uint256(work.merkle_root);
     header.nTime = work.timestamp;
     header.nBits = work.bits;
-    header.nNonce = nonce;
     
-    // Calculate RandomQ hash using optimized function
-    return RandomQMining::CalculateRandomQHashOptimized(header, nonce);
+    // Rounds are set before the prefix is absorbed; the midstate keeps them
+    RandomQMining::PrepareJob(job, header, m_randomq_rounds);
+}
+
+bool RandomQMiner::verifyKernel(const RandomQKernel::Kernel& kernel, const RandomQMining::HashJob& job, uint32_t nonce, size_t lane) {
+    // A full-width call, so the sample covers the same code path as HashRange
+    uint32_t nonces[RandomQKernel::MAX_LANES];
+    uint256 hashes[RandomQKernel::MAX_LANES];
+    for (size_t i = 0; i < kernel.lanes; i++) {
+        nonces[i] = nonce + static_cast<uint32_t>(i);
+    }
+    kernel.hash_lanes(job.midstate, nonces, hashes, kernel.lanes);
+    
+    lane %= kernel.lanes;
+    uint256 reference = RandomQMining::ReferenceHash(job, nonces[lane]);
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.verified_hashes++;
+    }
+    if (hashes[lane] != reference) {
+        onKernelFault(kernel, nonces[lane], hashes[lane], reference);
+        return false;
+    }
+    return true;
+}
+
+void RandomQMiner::onKernelFault(const RandomQKernel::Kernel& kernel, uint32_t nonce, const uint256& got, const uint256& want) {
+    log(0, "Kernel " + std::string(kernel.name) + " returned a wrong hash for nonce " + std::to_string(nonce));
+    log(0, "  Kernel:    " + got.ToString());
+    log(0, "  Reference: " + want.ToString());
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_stats.kernel_faults++;
+    }
+    
+    // Only the thread that disables the kernel picks the replacement
+    if (!RandomQKernel::Disable(kernel)) {
+        if (kernel.isa == RandomQKernel::Isa::GENERIC) {
+            log(0, "The generic kernel disagrees with the reference path; candidates from it are not submitted");
+        }
+        return;
+    }
+    const RandomQKernel::Kernel& next = RandomQKernel::Select(m_enable_avx2, m_enable_sse4);
+    log(1, "Kernel " + std::string(kernel.name) + " disabled, switched to " + next.name);
+    
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    m_stats.kernel = next.name;
 }
 
 void RandomQMiner::submitSolution(const WorkData& work, uint32_t nonce, const uint256& hash) {
@@ -263,27 +840,12 @@ void RandomQMiner::submitSolution(const WorkData& work, uint32_t nonce, const ui
     log(2, "  Target: " + work.target);
 }
 
-void RandomQMiner::updateStats(uint32_t hashes_processed) {
+void RandomQMiner::recordStaleAbort(std::chrono::steady_clock::duration latency) {
+    double ms = std::chrono::duration<double, std::milli>(latency).count();
     std::lock_guard<std::mutex> lock(m_stats_mutex);
-    
-    m_stats.total_hashes += hashes_processed;
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_start_time);
-    m_stats.elapsed_time = elapsed.count();
-    
-    if (m_stats.elapsed_time > 0) {
-        m_stats.hash_rate = static_cast<double>(m_stats.total_hashes) / m_stats.elapsed_time;
-    }
-    
-    // Print statistics if enabled
-    if (m_show_stats) {
-        auto time_since_last_stats = std::chrono::duration_cast<std::chrono::seconds>(now - m_last_stats_time);
-        if (time_since_last_stats.count() >= m_stats_interval) {
-            m_stats.print();
-            m_last_stats_time = now;
-        }
-    }
+    m_stats.stale_aborts++;
+    m_stats.stale_abort_ms_total += ms;
+    m_stats.stale_abort_ms_max = std::max(m_stats.stale_abort_ms_max, ms);
 }
 
 void RandomQMiner::log(int level, const std::string& message) const {
@@ -292,53 +854,3 @@ void RandomQMiner::log(int level, const std::string& message) const {
         std::cout << "[" << level_names[level] << "] " << message << std::endl;
     }
 }
-
-// WorkData implementation
-bool WorkData::isValid() const {
-    return !block_template.empty() && 
-           !previous_block_hash.empty() && 
-           !target.empty() && 
-           version != 0 && 
-           timestamp != 0 && 
-           bits != 0 && 
-           height != 0;
-}
-
-void WorkData::print() const {
-    std::cout << "Work Data:" << std::endl;
-    std::cout << "  Previous Block: " << previous_block_hash << std::endl;
-    std::cout << "  Target: " << target << std::endl;
-    std::cout << "  Version: " << version << std::endl;
-    std::cout << "  Timestamp: " << timestamp << std::endl;
-    std::cout << "  Bits: " << bits << std::endl;
-    std::cout << "  Height: " << height << std::endl;
-    std::cout << "  Nonce Range: " << nonce_start << " - " << nonce_end << std::endl;
-    std::cout << "  Transactions: " << transactions.size() << std::endl;
-}
-
-// MiningStats implementation
-void MiningStats::reset() {
-    total_hashes = 0;
-    valid_blocks = 0;
-    invalid_blocks = 0;
-    hash_rate = 0.0;
-    elapsed_time = 0.0;
-    current_nonce = 0;
-    current_target.clear();
-    best_hash.clear();
-    best_nonce = 0;
-}
-
-void MiningStats::print() const {
-    std::cout << "\n=== Mining Statistics ===" << std::endl;
-    std::cout << "Total Hashes: " << total_hashes << std::endl;
-    std::cout << "Valid Blocks: " << valid_blocks << std::endl;
-    std::cout << "Invalid Blocks: " << invalid_blocks << std::endl;
-    std::cout << "Hash Rate: " << std::fixed << std::setprecision(2) << hash_rate << " H/s" << std::endl;
-    std::cout << "Elapsed Time: " << elapsed_time << " seconds" << std::endl;
-    if (!best_hash.empty()) {
-        std::cout << "Best Hash: " << best_hash << std::endl;
-        std::cout << "Best Nonce: " << best_nonce << std::endl;
-    }
-    std::cout << "=========================" << std::endl;
-}
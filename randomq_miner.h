@@ -13,10 +13,28 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include "uint256.h"
+#include "mpsc_queue.h"
+#include "rpc_client.h"
 
 // Forward declarations
-struct WorkData;
+namespace RandomQMining {
+    struct HashJob;
+}
+namespace RandomQKernel {
+    struct Kernel;
+}
+
+// Snapshot of one mining thread's counters
+struct ThreadStats {
+    uint64_t hashes;
+    uint64_t candidates;        // Hashes that passed the target filter
+    uint64_t job;               // Generation of the job being hashed
+    double seconds_since_batch; // Time since the thread last finished a batch
+    HashRates rates;            // Recent rates of this thread
+};
 
 class RandomQMiner {
 public:
@@ -35,69 +53,189 @@ public:
     // Check if mining is running
     bool isRunning() const { return m_running; }
     
-    // Get current statistics
+    // Get current statistics, aggregated from the per-thread counters
     MiningStats getStats() const;
     
-    // Set new work
+    // Per-thread counters and recent rates of the running threads
+    std::vector<ThreadStats> getThreadStats() const;
+    
+    // Publish new work as an immutable job snapshot
     void setWork(const WorkData& work);
+    void setWork(std::shared_ptr<const WorkData> work);
     
-    // Set number of threads
+    // Drop the current work; threads idle until the next setWork()
+    void clearWork();
+    
+    // Set the number of threads. While mining, new threads join the current
+    // job and removed threads finish their nonce lease before they exit.
     void setThreadCount(int count);
     
+    // Number of mining threads configured, or running while mining
+    int getThreadCount() const { return m_num_threads.load(std::memory_order_relaxed); }
+    
     // Set RandomQ rounds
     void setRandomQRounds(uint64_t rounds);
     
     // Enable/disable optimizations
     void setOptimizations(bool avx2, bool sse4, bool optimized);
+    
+    // Force a hashing kernel by name; "auto" lets start() pick one
+    void setKernel(const std::string& name);
+    
+    // Set the number of nonces per hashing call and the first lease size
+    void setNonceBatch(uint32_t nonces);
+    
+    // Re-check 1 in this many hashes against the reference path; 0 disables sampling
+    void setVerifySample(uint64_t hashes);
+    
+    // Extend exhausted nonce ranges by rolling the version bits in mask, then
+    // nTime up to ntime_roll seconds past the wall clock
+    void setRolling(uint32_t version_mask, uint32_t ntime_roll);
+    
+    // Thread placement for start(): "none", "cores", "smt" or a CPU list,
+    // see CPUInfo::PlanAffinity
+    void setAffinity(const std::string& policy);
+    
+    // Called from a mining thread, once per job, when the threads run out of
+    // work on it: a block was found or no header variant is left
+    void setWorkRequest(std::function<void()> callback);
 
 private:
-    // Mining thread function
-    void miningThread(int thread_id);
+    // Immutable job snapshot, defined in randomq_miner.cpp
+    struct Job;
+    
+    // Kernel hash below the job's target, handed from a mining thread to the submitter
+    struct Solution {
+        std::shared_ptr<const Job> job;
+        uint32_t nonce = 0;
+        uint256 hash;
+        const RandomQKernel::Kernel* kernel = nullptr; // Kernel that produced hash
+    };
+    
+    // Counters written only by their mining thread, one cache line each so
+    // threads never share a line; readers aggregate them on demand
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> hashes{0};
+        std::atomic<uint64_t> candidates{0};
+        std::atomic<uint64_t> job{0};
+        std::atomic<int64_t> last_batch{0}; // steady_clock ticks
+    };
+    
+    // Mining thread function; cpu is the CPU to pin to, or -1
+    void miningThread(int thread_id, int cpu);
+    
+    // Grow or shrink the running pool to count threads; m_pool_mutex must be held
+    void resizePool(int count);
+    
+    // Wake parked threads to re-check the job, stop and retirement
+    void wakeThreads();
+    
+    // Sampler thread: feed the hash counters to the rate meters once a second
+    void sampleThread();
     
     // Check if work is valid
     bool checkWork(const WorkData& work);
     
-    // Calculate RandomQ hash
-    uint256 calculateHash(const WorkData& work, uint32_t nonce);
+    // Build the work's header and absorb its prefix into the job midstate
+    void prepareWork(const WorkData& work, RandomQMining::HashJob& job);
+    
+    // Prepare an unpublished job for work; nullptr if its nBits are rejected
+    std::shared_ptr<Job> makeJob(std::shared_ptr<const WorkData> work, uint32_t base_version, bool rolled);
+    
+    // Next header variant of a job with a fresh nonce range; nullptr if none is left
+    std::shared_ptr<Job> makeRolledJob(const Job& job);
+    
+    // Make job current under a new generation; m_work_mutex must be held
+    void publishJob(const std::shared_ptr<Job>& job);
+    
+    // Replace an exhausted current job with its rolled successor. True if newer
+    // work is current afterwards, false if the job could not be extended.
+    bool rollJob(const std::shared_ptr<const Job>& current);
+    
+    // Re-hash one lane of a full kernel call at nonce on the reference path
+    bool verifyKernel(const RandomQKernel::Kernel& kernel, const RandomQMining::HashJob& job, uint32_t nonce, size_t lane);
+    
+    // Submitter thread: drain m_solutions until stop() has joined the mining threads
+    void submitThread();
+    
+    // Verify a candidate on the reference path, check it against nBits and submit it
+    void processSolution(const Solution& solution);
+    
+    // Count a kernel hash that disagreed with the reference and stop using that kernel
+    void onKernelFault(const RandomQKernel::Kernel& kernel, uint32_t nonce, const uint256& got, const uint256& want);
     
     // Submit found solution
     void submitSolution(const WorkData& work, uint32_t nonce, const uint256& hash);
     
-    // Update statistics
-    void updateStats(uint32_t hashes_processed);
+    // Count a thread leaving stale work, latency measured from the new job's publication
+    void recordStaleAbort(std::chrono::steady_clock::duration latency);
     
     // Logging
     void log(int level, const std::string& message) const;
     
 private:
-    // Configuration
-    int m_num_threads;
+    // Configuration; the thread count is read by running threads
+    std::atomic<int> m_num_threads;
     uint64_t m_randomq_rounds;
     bool m_enable_avx2;
     bool m_enable_sse4;
     bool m_enable_optimized;
     bool m_submit_work;
-    
-    // Threading
+    std::string m_kernel_name;
+    uint32_t m_nonce_batch;
+    uint64_t m_verify_sample;
+    uint32_t m_version_mask;
+    uint32_t m_ntime_roll;
+    std::string m_affinity;
+    
+    // Threading. m_pool_mutex orders start(), stop() and resizes; threads with
+    // an id at or above m_active_threads retire after their current lease.
+    std::mutex m_pool_mutex;
     std::vector<std::thread> m_threads;
+    std::atomic<int> m_active_threads;
     std::atomic<bool> m_running;
     std::atomic<bool> m_should_stop;
     
-    // Work data
+    // Idle threads wait on this word (a futex on Linux); every event that
+    // could give them something to do increments it and notifies
+    std::atomic<uint32_t> m_wakeups;
+    
+    // Candidates from the mining threads; the submitter parks on
+    // m_solution_wakeups the same way idle mining threads park on m_wakeups
+    MpscQueue<Solution> m_solutions;
+    std::atomic<uint32_t> m_solution_wakeups;
+    std::atomic<bool> m_submit_stop;
+    std::thread m_submit_thread;
+    
+    std::function<void()> m_work_request;
+    std::atomic<uint64_t> m_work_requested; // Last job generation work was requested for
+    
+    // Current job, replaced as a whole by setWork(); m_work_mutex only orders
+    // concurrent publishers. The atomic shared_ptr is not lock-free: a load
+    // takes its internal lock bit and bumps the shared reference count, so
+    // threads contend briefly when they pick up a new job. The hashing loop
+    // polls m_job_generation instead and never touches m_job.
     std::mutex m_work_mutex;
-    WorkData m_current_work;
-    bool m_has_work;
+    std::atomic<std::shared_ptr<const Job>> m_job;
+    std::atomic<uint64_t> m_job_generation;
     
-    // Statistics
+    // Statistics. m_stats holds rare events and the totals of threads that
+    // have exited; m_stats_mutex also guards m_counters. Each thread
+    // allocates its own counters after pinning, so they stay on its NUMA node.
     mutable std::mutex m_stats_mutex;
     MiningStats m_stats;
+    std::vector<std::unique_ptr<ThreadCounters>> m_counters;
     std::chrono::steady_clock::time_point m_start_time;
-    std::chrono::steady_clock::time_point m_last_stats_time;
+    
+    // Rate meters, one per m_counters entry and one for the total; the
+    // sampler updates them under m_stats_mutex
+    std::vector<HashRateMeter> m_thread_meters;
+    HashRateMeter m_meter;
+    std::condition_variable m_sample_cv;
+    std::thread m_sample_thread;
     
     // Logging
     int m_log_level;
-    bool m_show_stats;
-    uint32_t m_stats_interval;
 };
 
 // WorkData is defined in rpc_client.h
@@ -11,70 +11,113 @@
 
 namespace RandomQMining {
 
+namespace {
+
+// Write the little-endian nonce into the last 4 header bytes
+void WriteNonce(std::span<unsigned char, CRandomQHash::HEADER_SIZE> out, uint32_t nonce) {
+    for (int i = 0; i < 4; i++) {
+        out[CRandomQHash::HEADER_PREFIX_SIZE + i] = nonce & 0xFF;
+        nonce >>= 8;
+    }
+}
+
+} // namespace
+
 uint256 CalculateRandomQHash(const CBlockHeader& header) {
     // Serialize block header
-    std::vector<unsigned char> header_data;
-    header_data.reserve(80); // Standard block header size
+    HeaderBytes header_data;
+    SerializeHeader(header, header_data);
     
-    // Serialize header fields
+    // Calculate RandomQ hash
+    return CalculateRandomQHash(header_data);
+}
+
+uint256 CalculateRandomQHashOptimized(const CBlockHeader& header, uint32_t nonce) {
+    // Serialize the header and patch in the new nonce instead of copying it
+    HeaderBytes header_data;
+    SerializeHeaderPrefix(header, std::span(header_data).first<CRandomQHash::HEADER_PREFIX_SIZE>());
+    WriteNonce(header_data, nonce);
+    
+    return CalculateRandomQHash(header_data);
+}
+
+void SerializeHeader(const CBlockHeader& header, std::span<unsigned char, CRandomQHash::HEADER_SIZE> out) {
+    SerializeHeaderPrefix(header, out.first<CRandomQHash::HEADER_PREFIX_SIZE>());
+    WriteNonce(out, header.nNonce);
+}
+
+void SerializeHeaderPrefix(const CBlockHeader& header, std::span<unsigned char, CRandomQHash::HEADER_PREFIX_SIZE> out) {
     uint32_t version = header.nVersion;
-    uint256 prevBlock = header.hashPrevBlock;
-    uint256 merkleRoot = header.hashMerkleRoot;
     uint32_t timestamp = header.nTime;
     uint32_t bits = header.nBits;
-    uint32_t nonce = header.nNonce;
     
     // Convert to little-endian byte order
     for (int i = 0; i < 4; i++) {
-        header_data.push_back(version & 0xFF);
+        out[i] = version & 0xFF;
         version >>= 8;
     }
     
-    // Add previous block hash
-    for (int i = 0; i < 32; i++) {
-        header_data.push_back(prevBlock.begin()[i]);
-    }
-    
-    // Add merkle root
-    for (int i = 0; i < 32; i++) {
-        header_data.push_back(merkleRoot.begin()[i]);
-    }
+    // Add previous block hash and merkle root
+    std::memcpy(out.data() + 4, header.hashPrevBlock.begin(), 32);
+    std::memcpy(out.data() + 36, header.hashMerkleRoot.begin(), 32);
     
     // Add timestamp
     for (int i = 0; i < 4; i++) {
-        header_data.push_back(timestamp & 0xFF);
+        out[68 + i] = timestamp & 0xFF;
         timestamp >>= 8;
     }
     
     // Add bits
     for (int i = 0; i < 4; i++) {
-        header_data.push_back(bits & 0xFF);
+        out[72 + i] = bits & 0xFF;
         bits >>= 8;
     }
-    
-    // Add nonce
-    for (int i = 0; i < 4; i++) {
-        header_data.push_back(nonce & 0xFF);
-        nonce >>= 8;
+}
+
+void PrepareMidstate(CRandomQHash& hasher, const CBlockHeader& header) {
+    std::array<unsigned char, CRandomQHash::HEADER_PREFIX_SIZE> prefix;
+    SerializeHeaderPrefix(header, prefix);
+    hasher.SetMidstate(prefix.data(), prefix.size());
+}
+
+void PrepareJob(HashJob& job, const CBlockHeader& header, uint64_t rounds) {
+    job.header = header;
+    job.rounds = rounds;
+    job.midstate.SetRandomQRounds(rounds);
+    PrepareMidstate(job.midstate, header);
+}
+
+bool RollHeader(uint32_t& version, uint32_t& time, uint32_t base_version, uint32_t mask, uint32_t time_limit) {
+    if (mask != 0) {
+        uint32_t bits = ((version | ~mask) + 1) & mask;
+        version = (version & ~mask) | bits;
+        if (bits != (base_version & mask)) {
+            return true;
+        }
+    }
+    if (time >= time_limit) {
+        return false;
     }
-    
-    // Calculate RandomQ hash
-    return CalculateRandomQHash(header_data);
+    time++;
+    return true;
 }
 
-uint256 CalculateRandomQHashOptimized(const CBlockHeader& header, uint32_t nonce) {
-    // Create a copy of the header with the new nonce
-    CBlockHeader header_copy = header;
-    header_copy.nNonce = nonce;
-    
-    return CalculateRandomQHash(header_copy);
+uint256 ReferenceHash(const HashJob& job, uint32_t nonce) {
+    CBlockHeader header = job.header;
+    header.nNonce = nonce;
+    HeaderBytes header_data;
+    SerializeHeader(header, header_data);
+    
+    CRandomQHash hasher;
+    hasher.SetRandomQRounds(job.rounds);
+    return CalculateRandomQHash(hasher, header_data);
 }
 
 bool CheckTarget(const uint256& hash, const uint256& target) {
     return hash < target;
 }
 
-bool CheckRandomQProofOfWork(const CBlockHeader& header, uint32_t nBits, const uint256& powLimit) {
+bool CheckRandomQProofOfWork(const CBlockHeader& header, uint32_t nBits, const uint256& powLimit, uint64_t rounds) {
     // Calculate target from nBits
     uint256 target = uint256().SetCompact(nBits);
     
@@ -84,7 +127,11 @@ bool CheckRandomQProofOfWork(const CBlockHeader& header, uint32_t nBits, const u
     }
     
     // Calculate hash
-    uint256 hash = CalculateRandomQHash(header);
+    HeaderBytes header_data;
+    SerializeHeader(header, header_data);
+    CRandomQHash hasher;
+    hasher.SetRandomQRounds(rounds);
+    uint256 hash = CalculateRandomQHash(hasher, header_data);
     
     // Check if hash meets target
     return CheckTarget(hash, target);
@@ -118,6 +165,10 @@ double MiningUtils::CalculateHashRate(uint64_t hashes, double elapsed_time) {
     return static_cast<double>(hashes) / elapsed_time;
 }
 
+HashRates MiningUtils::CalculateHashRate(const HashRateMeter& meter) {
+    return meter.Rates();
+}
+
 std::string MiningUtils::FormatHashRate(double hash_rate) {
     std::ostringstream oss;
     
@@ -134,6 +185,11 @@ std::string MiningUtils::FormatHashRate(double hash_rate) {
     return oss.str();
 }
 
+std::string MiningUtils::FormatHashRate(const HashRates& rates) {
+    return "10s: " + FormatHashRate(rates.rate_10s) + ", 60s: " + FormatHashRate(rates.rate_60s) +
+           ", 15m: " + FormatHashRate(rates.rate_15m) + ", ewma: " + FormatHashRate(rates.ewma);
+}
+
 double MiningUtils::EstimateMiningTime(double hash_rate, const uint256& target) {
     if (hash_rate <= 0 || target == uint256()) {
         return -1.0;
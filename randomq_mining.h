@@ -8,8 +8,16 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <span>
 #include "uint256.h"
 #include "block.h"
+#include "hash_rate.h"
+#include "randomq_hash.h"
+#include "randomq_kernel.h"
+#include "randomq_target.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
 
 // Forward declarations
 class CBlockHeader;
@@ -21,11 +29,63 @@ namespace RandomQMining {
     // Calculate RandomQ hash with optimizations
     uint256 CalculateRandomQHashOptimized(const CBlockHeader& header, uint32_t nonce);
     
+    // Serialize the 80-byte block header
+    void SerializeHeader(const CBlockHeader& header, std::span<unsigned char, CRandomQHash::HEADER_SIZE> out);
+    
+    // Serialize the 76-byte header prefix (all fields except nNonce)
+    void SerializeHeaderPrefix(const CBlockHeader& header, std::span<unsigned char, CRandomQHash::HEADER_PREFIX_SIZE> out);
+    
+    // Absorb the header prefix into the hasher once per job
+    void PrepareMidstate(CRandomQHash& hasher, const CBlockHeader& header);
+    
+    // Per-job hashing state: the header and its prefix midstate
+    struct HashJob {
+        CBlockHeader header;
+        CRandomQHash midstate;
+        uint64_t rounds = 0;
+    };
+    
+    // Prepare a job for hashing a header with the given round count
+    void PrepareJob(HashJob& job, const CBlockHeader& header, uint64_t rounds);
+    
+    // Step a header to its next variant for a fresh nonce range: the next
+    // version-bit combination under mask, then time + 1 once every
+    // combination has been used with the current time. False, leaving time
+    // alone, when time may not pass time_limit.
+    bool RollHeader(uint32_t& version, uint32_t& time, uint32_t base_version, uint32_t mask, uint32_t time_limit);
+    
+    // Hash one nonce of a job on the scalar path, bypassing midstate and kernels
+    uint256 ReferenceHash(const HashJob& job, uint32_t nonce);
+    
+    // RandomQ rounds one kernel call may run across its lanes. A job with
+    // more rounds per hash gets fewer lanes per call, down to one hash.
+    const uint64_t MAX_ROUNDS_PER_CALL = 8 * 8192;
+    
+    // Hash nonces [nonce_begin, nonce_begin + count) with the active kernel.
+    // on_hit(nonce, hash) is called only for hashes below filter; returning
+    // false from it stops the range early. Returns the number of hashes done.
+    template <typename Callback>
+    uint64_t HashRange(const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                       const CompiledTarget& filter, Callback&& on_hit);
+    
+    // As above, but should_stop() is polled before every kernel call and ends
+    // the range when it returns true, bounding the latency to one call of at
+    // most MAX_ROUNDS_PER_CALL rounds, or one hash if that has more
+    template <typename Callback, typename StopFn>
+    uint64_t HashRange(const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                       const CompiledTarget& filter, Callback&& on_hit, StopFn&& should_stop);
+    
+    // As above, on the given kernel instead of the active one, so the caller
+    // knows which kernel produced each hash passed to on_hit
+    template <typename Callback, typename StopFn>
+    uint64_t HashRange(const RandomQKernel::Kernel& kernel, const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                       const CompiledTarget& filter, Callback&& on_hit, StopFn&& should_stop);
+    
     // Check if a hash meets the target
     bool CheckTarget(const uint256& hash, const uint256& target);
     
     // Check proof of work
-    bool CheckRandomQProofOfWork(const CBlockHeader& header, uint32_t nBits, const uint256& powLimit);
+    bool CheckRandomQProofOfWork(const CBlockHeader& header, uint32_t nBits, const uint256& powLimit, uint64_t rounds = 8192);
     
     // Convert difficulty to target
     uint256 DifficultyToTarget(uint32_t difficulty);
@@ -39,9 +99,15 @@ namespace RandomQMining {
         // Calculate hash rate
         static double CalculateHashRate(uint64_t hashes, double elapsed_time);
         
+        // Current 10 s, 60 s and 15 min window rates and the EWMA of a meter
+        static HashRates CalculateHashRate(const HashRateMeter& meter);
+        
         // Format hash rate
         static std::string FormatHashRate(double hash_rate);
         
+        // Format window rates as "10s: ..., 60s: ..., 15m: ..., ewma: ..."
+        static std::string FormatHashRate(const HashRates& rates);
+        
         // Calculate mining time estimate
         static double EstimateMiningTime(double hash_rate, const uint256& target);
         
@@ -50,4 +116,51 @@ namespace RandomQMining {
     };
 }
 
+template <typename Callback>
+uint64_t RandomQMining::HashRange(const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                                  const CompiledTarget& filter, Callback&& on_hit) {
+    return HashRange(job, nonce_begin, count, filter, std::forward<Callback>(on_hit), [] { return false; });
+}
+
+template <typename Callback, typename StopFn>
+uint64_t RandomQMining::HashRange(const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                                  const CompiledTarget& filter, Callback&& on_hit, StopFn&& should_stop) {
+    // Resolve the kernel once per range rather than once per batch
+    return HashRange(RandomQKernel::Active(), job, nonce_begin, count, filter, std::forward<Callback>(on_hit),
+                     std::forward<StopFn>(should_stop));
+}
+
+template <typename Callback, typename StopFn>
+uint64_t RandomQMining::HashRange(const RandomQKernel::Kernel& kernel, const HashJob& job, uint32_t nonce_begin, uint64_t count,
+                                  const CompiledTarget& filter, Callback&& on_hit, StopFn&& should_stop) {
+    uint32_t nonces[RandomQKernel::MAX_LANES];
+    uint256 hashes[RandomQKernel::MAX_LANES];
+    uint64_t done = 0;
+    
+    // Kernels hash their lanes one after another, so a call costs lanes * rounds
+    const uint64_t max_lanes = std::clamp<uint64_t>(MAX_ROUNDS_PER_CALL / std::max<uint64_t>(job.rounds, 1), 1, kernel.lanes);
+    
+    while (done < count && !should_stop()) {
+        size_t lanes = static_cast<size_t>(std::min<uint64_t>(max_lanes, count - done));
+        for (size_t i = 0; i < lanes; i++) {
+            nonces[i] = static_cast<uint32_t>(nonce_begin + done + i);
+        }
+        
+        kernel.hash_lanes(job.midstate, nonces, hashes, lanes);
+        done += lanes;
+        
+        // Reject lanes on their most significant word, then compare survivors in full
+        uint32_t candidates = kernel.filter_lanes(hashes, lanes, filter.words[3]);
+        while (candidates != 0) {
+            size_t i = std::countr_zero(candidates);
+            candidates &= candidates - 1;
+            if (filter.Check(hashes[i]) && !on_hit(nonces[i], hashes[i])) {
+                return done;
+            }
+        }
+    }
+    
+    return done;
+}
+
 #endif // CPUMINER_RANDOMQ_MINING_H
@@ -0,0 +1,33 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "randomq_target.h"
+
+CompiledTarget CompiledTarget::FromTarget(const uint256& target) {
+    CompiledTarget compiled;
+    for (int i = 0; i < 4; i++) {
+        compiled.words[i] = ReadWord(target.begin() + 8 * i);
+    }
+    return compiled;
+}
+
+bool CompiledTarget::FromCompact(uint32_t bits, CompiledTarget& out) {
+    bool negative = false;
+    bool overflow = false;
+    uint256 target;
+    target.SetCompact(bits, &negative, &overflow);
+    if (negative || overflow || target == uint256()) {
+        return false;
+    }
+    out = FromTarget(target);
+    return true;
+}
+
+bool CompiledTarget::FromWork(const std::string& target, uint32_t bits, CompiledTarget& out) {
+    if (target.empty()) {
+        return FromCompact(bits, out);
+    }
+    out = FromTarget(uint256(target));
+    return true;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_RANDOMQ_TARGET_H
+#define CPUMINER_RANDOMQ_TARGET_H
+
+#include <cstdint>
+#include <string>
+#include "uint256.h"
+
+/**
+ * Mining target decoded once per job into 64-bit words, least significant
+ * word first, so checking a hash costs one word compare in almost all cases.
+ */
+struct CompiledTarget {
+    uint64_t words[4];
+    
+    // Decode from a uint256 target
+    static CompiledTarget FromTarget(const uint256& target);
+    
+    // Decode from compact nBits. False for the encodings consensus rejects:
+    // a negative or overflowing value, or a zero target.
+    static bool FromCompact(uint32_t bits, CompiledTarget& out);
+    
+    // Decode from a hex target string, falling back to compact bits when it
+    // is empty; false when those bits are rejected by FromCompact()
+    static bool FromWork(const std::string& target, uint32_t bits, CompiledTarget& out);
+    
+    // Most significant 64-bit word of a hash
+    static uint64_t TopWord(const uint256& hash) {
+        return ReadWord(hash.begin() + 24);
+    }
+    
+    // Check if hash < target; rejects on the most significant word first
+    bool Check(const uint256& hash) const {
+        uint64_t top = TopWord(hash);
+        if (top != words[3]) {
+            return top < words[3];
+        }
+        for (int i = 2; i >= 0; i--) {
+            uint64_t word = ReadWord(hash.begin() + 8 * i);
+            if (word != words[i]) {
+                return word < words[i];
+            }
+        }
+        return false;
+    }
+    
+    static uint64_t ReadWord(const unsigned char* p) {
+        return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) |
+               (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24) |
+               (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40) |
+               (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
+    }
+};
+
+#endif // CPUMINER_RANDOMQ_TARGET_H
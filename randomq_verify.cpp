@@ -0,0 +1,125 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "randomq_verify.h"
+#include "cpu_info.h"
+#include "randomq_hash.h"
+#include "randomq_kernel.h"
+#include "randomq_target.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace RandomQVerify {
+
+namespace {
+
+uint32_t ReadBits(const unsigned char* header) {
+    const unsigned char* p = header + 72;
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint32_t ReadNonce(const unsigned char* header) {
+    const unsigned char* p = header + CRandomQHash::HEADER_PREFIX_SIZE;
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Same target rules as RandomQMining::CheckRandomQProofOfWork
+bool DecodeTarget(const unsigned char* header, const uint256& pow_limit, CompiledTarget& target) {
+    uint256 decoded = uint256().SetCompact(ReadBits(header));
+    if (decoded == uint256() || decoded > pow_limit) {
+        return false;
+    }
+    target = CompiledTarget::FromTarget(decoded);
+    return true;
+}
+
+// Verify headers [begin, end); begin is a multiple of 8 so no two workers share a bitmap byte
+size_t VerifyRange(const unsigned char* headers, size_t begin, size_t end, const Options& options, uint8_t* bitmap) {
+    const RandomQKernel::Kernel& kernel = RandomQKernel::Active();
+    CRandomQHash hasher;
+    hasher.SetRandomQRounds(options.rounds);
+    CRandomQHash midstate;
+    midstate.SetRandomQRounds(options.rounds);
+    uint32_t nonces[RandomQKernel::MAX_LANES];
+    uint256 hashes[RandomQKernel::MAX_LANES];
+    size_t passed = 0;
+    
+    size_t i = begin;
+    while (i < end) {
+        const unsigned char* header = headers + i * HEADER_SIZE;
+        
+        // Consecutive headers with the same prefix share a midstate
+        size_t run = 1;
+        while (run < kernel.lanes && i + run < end &&
+               std::memcmp(header, header + run * HEADER_SIZE, CRandomQHash::HEADER_PREFIX_SIZE) == 0) {
+            run++;
+        }
+        
+        if (run > 1) {
+            midstate.SetMidstate(header, CRandomQHash::HEADER_PREFIX_SIZE);
+            for (size_t lane = 0; lane < run; lane++) {
+                nonces[lane] = ReadNonce(header + lane * HEADER_SIZE);
+            }
+            kernel.hash_lanes(midstate, nonces, hashes, run);
+        } else {
+            hashes[0] = RandomQMining::CalculateRandomQHash(hasher, std::span<const unsigned char, HEADER_SIZE>(header, HEADER_SIZE));
+        }
+        
+        // All headers in a run share nBits, so the target is decoded once
+        CompiledTarget target;
+        if (DecodeTarget(header, options.pow_limit, target)) {
+            for (size_t lane = 0; lane < run; lane++) {
+                if (target.Check(hashes[lane])) {
+                    bitmap[(i + lane) / 8] |= 1 << ((i + lane) % 8);
+                    passed++;
+                }
+            }
+        }
+        i += run;
+    }
+    
+    return passed;
+}
+
+} // namespace
+
+Result VerifyHeaders(std::span<const unsigned char> headers, const Options& options) {
+    Result result;
+    result.count = headers.size() / HEADER_SIZE;
+    result.bitmap.assign((result.count + 7) / 8, 0);
+    if (result.count == 0) {
+        return result;
+    }
+    
+    // Workers get whole bitmap bytes: chunks of a multiple of 8 headers
+    size_t threads = options.threads > 0 ? options.threads : CPUInfo::UsableCpuCount();
+    threads = std::min(threads, (result.count + 7) / 8);
+    size_t chunk = ((result.count + threads - 1) / threads + 7) / 8 * 8;
+    
+    std::vector<size_t> passed(threads, 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end = std::min(result.count, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        workers.emplace_back([&, t, begin, end] {
+            passed[t] = VerifyRange(headers.data(), begin, end, options, result.bitmap.data());
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    
+    for (size_t count : passed) {
+        result.passed += count;
+    }
+    return result;
+}
+
+} // namespace RandomQVerify
@@ -0,0 +1,47 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_RANDOMQ_VERIFY_H
+#define CPUMINER_RANDOMQ_VERIFY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "uint256.h"
+
+/**
+ * Batch proof-of-work verification for serialized 80-byte block headers,
+ * each checked against the target encoded in its own nBits field.
+ *
+ * Headers are split across worker threads. Runs of consecutive headers
+ * that differ only in nNonce share one midstate and go through the active
+ * multi-lane kernel; all other headers use the reused fixed-size hasher.
+ */
+namespace RandomQVerify {
+    static const size_t HEADER_SIZE = 80;
+
+    struct Options {
+        uint64_t rounds = 8192;
+        uint256 pow_limit = uint256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+        unsigned int threads = 0; // 0 uses every CPU the process may run on
+    };
+
+    struct Result {
+        // Bit i % 8 of byte i / 8 is set if header i passes
+        std::vector<uint8_t> bitmap;
+        size_t count = 0;
+        size_t passed = 0;
+    };
+
+    // Verify headers.size() / 80 headers stored back to back
+    Result VerifyHeaders(std::span<const unsigned char> headers, const Options& options);
+
+    // Check whether header i passed in a result bitmap
+    inline bool Passed(const Result& result, size_t i) {
+        return (result.bitmap[i / 8] >> (i % 8)) & 1;
+    }
+}
+
+#endif // CPUMINER_RANDOMQ_VERIFY_H
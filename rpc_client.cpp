@@ -4,6 +4,7 @@
 
 #include "rpc_client.h"
 #include "randomq_miner.h"
+#include "randomq_mining.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -15,7 +16,7 @@ RPCClient::RPCClient()
     , m_connected(false)
     , m_running(false)
     , m_should_stop(false)
-    , m_has_work(false)
+    , m_work_requested(false)
     , m_miner(nullptr)
     , m_log_level(2)
 {
@@ -63,7 +64,11 @@ void RPCClient::stop() {
     }
     
     log(2, "Stopping RPC client...");
-    m_should_stop = true;
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_should_stop = true;
+    }
+    m_wake_cv.notify_all();
     
     // Wait for work thread to finish
     if (m_work_thread.joinable()) {
@@ -76,7 +81,7 @@ void RPCClient::stop() {
     log(2, "RPC client stopped");
 }
 
-WorkData RPCClient::getCurrentWork() const {
+std::shared_ptr<const WorkData> RPCClient::getCurrentWork() const {
     std::lock_guard<std::mutex> lock(m_work_mutex);
     return m_current_work;
 }
@@ -160,17 +165,18 @@ void RPCClient::updateWork() {
     // Get new work from RPC
     std::string response = rpcCall("getblocktemplate");
     
-    // Parse work template
-    WorkData work = parseWorkTemplate(response);
+    // Parse work template into the snapshot shared with the miner
+    auto work = std::make_shared<const WorkData>(parseWorkTemplate(response));
     
-    if (work.isValid()) {
-        std::lock_guard<std::mutex> lock(m_work_mutex);
-        m_current_work = work;
-        m_has_work = true;
+    if (work->isValid()) {
+        {
+            std::lock_guard<std::mutex> lock(m_work_mutex);
+            m_current_work = work;
+        }
         
         // Set work in miner
         if (m_miner) {
-            m_miner->setWork(work);
+            m_miner->setWork(std::move(work));
         }
         
         log(2, "Work updated");
@@ -179,6 +185,14 @@ void RPCClient::updateWork() {
     }
 }
 
+void RPCClient::requestWork() {
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_work_requested = true;
+    }
+    m_wake_cv.notify_all();
+}
+
 void RPCClient::workThread() {
     log(2, "Work thread started");
     
@@ -192,13 +206,16 @@ void RPCClient::workThread() {
             // Update work
             updateWork();
             
-            // Wait before next update
-            std::this_thread::sleep_for(std::chrono::seconds(30));
+            // Wait for the next refresh, a work request or stop()
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_cv.wait_for(lock, std::chrono::seconds(30), [this] { return m_should_stop || m_work_requested; });
+            m_work_requested = false;
             
         } catch (const std::exception& e) {
             log(0, "Work thread error: " + std::string(e.what()));
             disconnect();
-            std::this_thread::sleep_for(std::chrono::seconds(5));
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_cv.wait_for(lock, std::chrono::seconds(5), [this] { return m_should_stop.load(); });
         }
     }
     
@@ -236,6 +253,8 @@ WorkData RPCClient::parseWorkTemplate(const std::string& json) {
     work.nonce_start = 0;
     work.nonce_end = 0xFFFFFFFF;
     
+    // The mock template has no "mutable", so it permits no header rolling
+    
     return work;
 }
 
@@ -254,12 +273,12 @@ void RPCClient::log(int level, const std::string& message) const {
 
 // WorkData implementation
 bool WorkData::isValid() const {
+    // The target may come from either the target string or nBits
     return !block_template.empty() && 
            !previous_block_hash.empty() && 
-           !target.empty() && 
+           (!target.empty() || bits != 0) && 
            version != 0 && 
            timestamp != 0 && 
-           bits != 0 && 
            height != 0;
 }
 
@@ -278,23 +297,52 @@ void WorkData::print() const {
 // MiningStats implementation
 void MiningStats::reset() {
     total_hashes = 0;
+    candidates = 0;
     valid_blocks = 0;
     invalid_blocks = 0;
     hash_rate = 0.0;
+    rates = HashRates();
     elapsed_time = 0.0;
     current_nonce = 0;
     current_target.clear();
     best_hash.clear();
     best_nonce = 0;
+    kernel.clear();
+    sha256_impl.clear();
+    verified_hashes = 0;
+    kernel_faults = 0;
+    stale_aborts = 0;
+    dropped_solutions = 0;
+    stale_abort_ms_total = 0.0;
+    stale_abort_ms_max = 0.0;
 }
 
 void MiningStats::print() const {
     std::cout << "\n=== Mining Statistics ===" << std::endl;
     std::cout << "Total Hashes: " << total_hashes << std::endl;
+    if (candidates > 0) {
+        std::cout << "Candidates: " << candidates << std::endl;
+    }
+    if (dropped_solutions > 0) {
+        std::cout << "Dropped Candidates: " << dropped_solutions << std::endl;
+    }
     std::cout << "Valid Blocks: " << valid_blocks << std::endl;
     std::cout << "Invalid Blocks: " << invalid_blocks << std::endl;
     std::cout << "Hash Rate: " << std::fixed << std::setprecision(2) << hash_rate << " H/s" << std::endl;
+    if (rates.ewma > 0) {
+        std::cout << "Recent Hash Rate: " << RandomQMining::MiningUtils::FormatHashRate(rates) << std::endl;
+    }
     std::cout << "Elapsed Time: " << elapsed_time << " seconds" << std::endl;
+    if (!kernel.empty()) {
+        std::cout << "Kernel: " << kernel << " (SHA256: " << sha256_impl << ")" << std::endl;
+    }
+    if (verified_hashes > 0) {
+        std::cout << "Verified Hashes: " << verified_hashes << " (" << kernel_faults << " kernel faults)" << std::endl;
+    }
+    if (stale_aborts > 0) {
+        std::cout << "Stale Work Aborts: " << stale_aborts << " (avg " << std::setprecision(3)
+                  << stale_abort_ms_total / stale_aborts << " ms, max " << stale_abort_ms_max << " ms)" << std::endl;
+    }
     if (!best_hash.empty()) {
         std::cout << "Best Hash: " << best_hash << std::endl;
         std::cout << "Best Nonce: " << best_nonce << std::endl;
@@ -13,6 +13,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <memory>
+#include "hash_rate.h"
 
 // Forward declarations
 class RandomQMiner;
@@ -31,6 +33,13 @@ struct WorkData {
     uint32_t nonce_end;
     std::vector<std::string> transactions;
     
+    // Header rolling the template permits; none unless it says so. Rolling
+    // only moves nTime forward from the template's own time, so "mintime"
+    // needs no check of its own.
+    uint32_t version_mask = 0;  // Version bits the miner may change: the "mutable" version rules minus "vbavailable" bits
+    bool time_mutable = false;  // "time" or "time/increment" listed in "mutable"
+    uint32_t max_time = 0;      // "maxtime"; 0 when the template sets none
+    
     // Validation
     bool isValid() const;
     
@@ -41,14 +50,24 @@ struct WorkData {
 // Mining statistics
 struct MiningStats {
     uint64_t total_hashes;
+    uint64_t candidates;        // Hashes that passed the target filter
     uint64_t valid_blocks;
     uint64_t invalid_blocks;
-    double hash_rate;
+    double hash_rate;           // Average since start
+    HashRates rates;            // Recent rates, sampled once a second
     double elapsed_time;
     uint32_t current_nonce;
     std::string current_target;
     std::string best_hash;
     uint32_t best_nonce;
+    std::string kernel;
+    std::string sha256_impl;
+    uint64_t verified_hashes;   // Re-hashed on the reference path
+    uint64_t kernel_faults;     // Kernel hashes that disagreed with the reference
+    uint64_t stale_aborts;      // Times a thread left a job replaced by newer work
+    uint64_t dropped_solutions; // Candidates lost because the submit queue was full
+    double stale_abort_ms_total;
+    double stale_abort_ms_max;
     
     // Reset statistics
     void reset();
@@ -76,8 +95,11 @@ public:
     // Check if connected
     bool isConnected() const { return m_connected; }
     
-    // Get current work
-    WorkData getCurrentWork() const;
+    // Get current work; nullptr until the first valid template arrives
+    std::shared_ptr<const WorkData> getCurrentWork() const;
+    
+    // Fetch a new template now instead of at the next refresh
+    void requestWork();
     
     // Submit solution
     bool submitSolution(const WorkData& work, uint32_t nonce, const std::string& hash);
@@ -125,17 +147,20 @@ private:
     std::atomic<bool> m_running;
     std::atomic<bool> m_should_stop;
     
-    // Work data
+    // Work data, shared with the miner without copying
     mutable std::mutex m_work_mutex;
-    WorkData m_current_work;
-    bool m_has_work;
+    std::shared_ptr<const WorkData> m_current_work;
     
     // Statistics
     mutable std::mutex m_stats_mutex;
     MiningStats m_stats;
     
-    // Threading
+    // Threading; the work thread sleeps on m_wake_cv between template
+    // refreshes, woken early by stop() and requestWork()
     std::thread m_work_thread;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake_cv;
+    bool m_work_requested;
     
     // Miner reference
     RandomQMiner* m_miner;
@@ -0,0 +1,79 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sha256_lanes.h"
+#include "cpu_info.h"
+#include "randomq_kernel.h"
+#include "sha256.h"
+
+namespace Sha256Lanes {
+
+#if defined(ENABLE_SHA256_LANES_AVX2)
+// Defined in sha256_lanes_avx2.cpp
+void Hash_AVX2(const unsigned char* const* inputs, size_t len, unsigned char (*out)[OUTPUT_SIZE], size_t lanes);
+#endif
+
+namespace {
+
+enum class Backend {
+    GENERIC,
+    SHANI,
+    AVX2
+};
+
+Backend SelectBackend() {
+    // Make sure CSHA256 runs on the fastest transform (SHA-NI if present)
+    RandomQKernel::Sha256Implementation();
+    
+    const CPUFeatures& features = CPUInfo::GetFeatures();
+    
+    // A single SHA-NI stream beats 8-way AVX2, so prefer it when present
+    if (features.sha) {
+        return Backend::SHANI;
+    }
+#if defined(ENABLE_SHA256_LANES_AVX2)
+    if (features.avx2) {
+        return Backend::AVX2;
+    }
+#endif
+    return Backend::GENERIC;
+}
+
+Backend GetBackend() {
+    static const Backend backend = SelectBackend();
+    return backend;
+}
+
+} // namespace
+
+void Hash(const unsigned char* const* inputs, size_t len, unsigned char (*out)[OUTPUT_SIZE], size_t lanes) {
+    if (lanes > MAX_LANES) {
+        lanes = MAX_LANES;
+    }
+    
+#if defined(ENABLE_SHA256_LANES_AVX2)
+    if (GetBackend() == Backend::AVX2 && lanes > 1) {
+        Hash_AVX2(inputs, len, out, lanes);
+        return;
+    }
+#endif
+    
+    for (size_t i = 0; i < lanes; i++) {
+        CSHA256().Write(inputs[i], len).Finalize(out[i]);
+    }
+}
+
+const char* Implementation() {
+    switch (GetBackend()) {
+    case Backend::SHANI:
+        return "sha-ni";
+    case Backend::AVX2:
+        return "avx2 8-way";
+    case Backend::GENERIC:
+        break;
+    }
+    return "generic";
+}
+
+} // namespace Sha256Lanes
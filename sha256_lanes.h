@@ -0,0 +1,36 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_SHA256_LANES_H
+#define CPUMINER_SHA256_LANES_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Batched SHA256 over equal-length messages, shaped like
+ * RandomQKernel::HashLanes so the SHA stages can be fed one batch of
+ * nonces at a time.
+ *
+ * On CPUs with SHA-NI each lane goes through CSHA256, whose transform
+ * SHA256AutoDetect() has switched to SHA-NI. Without SHA-NI, AVX2 CPUs
+ * hash all lanes at once with an 8-way multi-buffer transform.
+ *
+ * Only cpuminer-bench builds and calls this. The SHA256 stages of a
+ * RandomQ hash run inside CRandomQ, so the mining and verify paths use
+ * CSHA256 with the transform reported by RandomQKernel::Sha256Implementation().
+ */
+namespace Sha256Lanes {
+    // Maximum number of messages hashed per call
+    static const size_t MAX_LANES = 8;
+    static const size_t OUTPUT_SIZE = 32;
+    
+    // Hash inputs[0..lanes), each len bytes long, into out[0..lanes)
+    void Hash(const unsigned char* const* inputs, size_t len, unsigned char (*out)[OUTPUT_SIZE], size_t lanes);
+    
+    // Name of the backend used by Hash()
+    const char* Implementation();
+}
+
+#endif // CPUMINER_SHA256_LANES_H
@@ -0,0 +1,160 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 8-way multi-buffer SHA256; only called after cpuid reports AVX2 support.
+
+#include "sha256_lanes.h"
+#include <immintrin.h>
+#include <cstring>
+
+namespace Sha256Lanes {
+
+namespace {
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+template <int N>
+inline __m256i Rotr(__m256i x) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+inline __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+inline __m256i Xor(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+
+inline __m256i Sigma0(__m256i x) { return Xor(Xor(Rotr<2>(x), Rotr<13>(x)), Rotr<22>(x)); }
+inline __m256i Sigma1(__m256i x) { return Xor(Xor(Rotr<6>(x), Rotr<11>(x)), Rotr<25>(x)); }
+inline __m256i sigma0(__m256i x) { return Xor(Xor(Rotr<7>(x), Rotr<18>(x)), _mm256_srli_epi32(x, 3)); }
+inline __m256i sigma1(__m256i x) { return Xor(Xor(Rotr<17>(x), Rotr<19>(x)), _mm256_srli_epi32(x, 10)); }
+
+inline __m256i Ch(__m256i e, __m256i f, __m256i g) {
+    return Xor(g, _mm256_and_si256(e, Xor(f, g)));
+}
+
+inline __m256i Maj(__m256i a, __m256i b, __m256i c) {
+    return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+}
+
+inline uint32_t ReadBE32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline void WriteBE32(unsigned char* p, uint32_t x) {
+    p[0] = x >> 24;
+    p[1] = x >> 16;
+    p[2] = x >> 8;
+    p[3] = x;
+}
+
+// One compression of eight independent 64-byte blocks, one per 32-bit lane
+void Transform8(__m256i state[8], const unsigned char blocks[8][64]) {
+    __m256i w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = _mm256_setr_epi32(
+            ReadBE32(blocks[0] + 4 * i), ReadBE32(blocks[1] + 4 * i),
+            ReadBE32(blocks[2] + 4 * i), ReadBE32(blocks[3] + 4 * i),
+            ReadBE32(blocks[4] + 4 * i), ReadBE32(blocks[5] + 4 * i),
+            ReadBE32(blocks[6] + 4 * i), ReadBE32(blocks[7] + 4 * i));
+    }
+    
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            // Message schedule, kept as a rolling 16-word window
+            w[i & 15] = Add(Add(sigma1(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                            Add(sigma0(w[(i - 15) & 15]), w[i & 15]));
+        }
+        __m256i t1 = Add(Add(Add(h, Sigma1(e)), Add(Ch(e, f, g), _mm256_set1_epi32(K[i]))), w[i & 15]);
+        __m256i t2 = Add(Sigma0(a), Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+    
+    state[0] = Add(state[0], a);
+    state[1] = Add(state[1], b);
+    state[2] = Add(state[2], c);
+    state[3] = Add(state[3], d);
+    state[4] = Add(state[4], e);
+    state[5] = Add(state[5], f);
+    state[6] = Add(state[6], g);
+    state[7] = Add(state[7], h);
+}
+
+} // namespace
+
+void Hash_AVX2(const unsigned char* const* inputs, size_t len, unsigned char (*out)[OUTPUT_SIZE], size_t lanes) {
+    // Unused lanes repeat lane 0; their output is discarded
+    const unsigned char* lane_input[8];
+    for (size_t i = 0; i < 8; i++) {
+        lane_input[i] = inputs[i < lanes ? i : 0];
+    }
+    
+    __m256i state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_set1_epi32(INITIAL_STATE[i]);
+    }
+    
+    // All messages have the same length, so they share one padding layout
+    const size_t total_blocks = (len + 9 + 63) / 64;
+    const uint64_t bit_length = static_cast<uint64_t>(len) * 8;
+    alignas(32) unsigned char blocks[8][64];
+    
+    for (size_t block = 0; block < total_blocks; block++) {
+        const size_t offset = block * 64;
+        for (size_t lane = 0; lane < 8; lane++) {
+            unsigned char* dst = blocks[lane];
+            if (offset + 64 <= len) {
+                std::memcpy(dst, lane_input[lane] + offset, 64);
+                continue;
+            }
+            
+            size_t copied = offset < len ? len - offset : 0;
+            if (copied > 0) {
+                std::memcpy(dst, lane_input[lane] + offset, copied);
+            }
+            std::memset(dst + copied, 0, 64 - copied);
+            if (offset <= len) {
+                dst[len - offset] = 0x80;
+            }
+            if (block == total_blocks - 1) {
+                for (int i = 0; i < 8; i++) {
+                    dst[63 - i] = static_cast<unsigned char>(bit_length >> (8 * i));
+                }
+            }
+        }
+        Transform8(state, blocks);
+    }
+    
+    alignas(32) uint32_t words[8][8];
+    for (int i = 0; i < 8; i++) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), state[i]);
+    }
+    for (size_t lane = 0; lane < lanes; lane++) {
+        for (int i = 0; i < 8; i++) {
+            WriteBE32(out[lane] + 4 * i, words[i][lane]);
+        }
+    }
+}
+
+} // namespace Sha256Lanes
@@ -0,0 +1,19 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_TEST_ALLOC_COUNTER_H
+#define CPUMINER_TEST_ALLOC_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * Test hook counting heap allocations. Linking alloc_counter.cpp into a
+ * test binary replaces the global operator new.
+ */
+namespace AllocCounter {
+    // Number of operator new calls since program start
+    uint64_t Count();
+}
+
+#endif // CPUMINER_TEST_ALLOC_COUNTER_H
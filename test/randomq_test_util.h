@@ -0,0 +1,160 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef CPUMINER_TEST_RANDOMQ_TEST_UTIL_H
+#define CPUMINER_TEST_RANDOMQ_TEST_UTIL_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include "block.h"
+#include "randomq_hash.h"
+#include "randomq_kernel.h"
+#include "randomq_mining.h"
+
+/**
+ * Helpers shared by the RandomQ test programs. The reference hash drives
+ * CRandomQ directly, bypassing every cpuminer hashing path under test.
+ */
+namespace RandomQTest {
+
+// Hash an 80-byte header with a freshly initialized CRandomQ
+inline uint256 ReferenceHash(std::span<const unsigned char, CRandomQHash::HEADER_SIZE> header, uint64_t rounds) {
+    CRandomQ randomq;
+    randomq.Initialize(nullptr, 0);
+    randomq.SetRounds(rounds);
+    randomq.SetNonce(0);
+    randomq.Write(header);
+    
+    uint256 result;
+    randomq.Finalize(result.begin());
+    return result;
+}
+
+inline uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Inverse of RandomQMining::SerializeHeader()
+inline CBlockHeader HeaderFromBytes(std::span<const unsigned char, CRandomQHash::HEADER_SIZE> data) {
+    CBlockHeader header;
+    header.nVersion = static_cast<int32_t>(ReadLE32(data.data()));
+    std::memcpy(header.hashPrevBlock.begin(), data.data() + 4, 32);
+    std::memcpy(header.hashMerkleRoot.begin(), data.data() + 36, 32);
+    header.nTime = ReadLE32(data.data() + 68);
+    header.nBits = ReadLE32(data.data() + 72);
+    header.nNonce = ReadLE32(data.data() + 76);
+    return header;
+}
+
+// Decode hex into out; fails unless the string is exactly out.size() bytes
+inline bool ParseHex(const std::string& hex, std::span<unsigned char> out) {
+    if (hex.size() != out.size() * 2) {
+        return false;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    for (size_t i = 0; i < out.size(); i++) {
+        int hi = nibble(hex[2 * i]);
+        int lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return true;
+}
+
+inline std::string ToHex(std::span<const unsigned char> data) {
+    static const char* digits = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(data.size() * 2);
+    for (unsigned char c : data) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0xF];
+    }
+    return hex;
+}
+
+inline bool ReportMismatch(const std::string& name, const std::string& path, const uint256& got, const uint256& want) {
+    if (got == want) {
+        return true;
+    }
+    std::cerr << "FAIL: " << name << ": " << path << " returned " << got.ToString()
+              << ", reference " << want.ToString() << std::endl;
+    return false;
+}
+
+// Hash the header through every cpuminer path and compare each with reference.
+// Every lane of every supported kernel is fed the same nonce, so each lane
+// position is checked. Leaves the previously active kernel active.
+inline bool CheckAllPaths(const std::string& name, std::span<const unsigned char, CRandomQHash::HEADER_SIZE> data,
+                          uint64_t rounds, const uint256& reference) {
+    bool ok = true;
+    const CBlockHeader header = HeaderFromBytes(data);
+    
+    // Reused hasher, twice to check that Reset() keeps nothing from the last header
+    CRandomQHash hasher;
+    hasher.SetRandomQRounds(rounds);
+    ok &= ReportMismatch(name, "CalculateRandomQHash(hasher, span)", RandomQMining::CalculateRandomQHash(hasher, data), reference);
+    ok &= ReportMismatch(name, "CalculateRandomQHash(hasher, span) reused", RandomQMining::CalculateRandomQHash(hasher, data), reference);
+    
+    // Convenience paths always hash with the default round count
+    if (rounds == 8192) {
+        ok &= ReportMismatch(name, "CalculateRandomQHash(span)", RandomQMining::CalculateRandomQHash(data), reference);
+        ok &= ReportMismatch(name, "CalculateRandomQHash(header)", RandomQMining::CalculateRandomQHash(header), reference);
+        ok &= ReportMismatch(name, "CalculateRandomQHashOptimized", RandomQMining::CalculateRandomQHashOptimized(header, header.nNonce), reference);
+    }
+    
+    RandomQMining::HashJob job;
+    RandomQMining::PrepareJob(job, header, rounds);
+    ok &= ReportMismatch(name, "midstate", job.midstate.GetHashFromMidstate(header.nNonce), reference);
+    ok &= ReportMismatch(name, "ReferenceHash(job)", RandomQMining::ReferenceHash(job, header.nNonce), reference);
+    
+    const RandomQKernel::Kernel& active = RandomQKernel::Active();
+    const CompiledTarget any_hash = CompiledTarget::FromTarget(uint256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        
+        uint32_t nonces[RandomQKernel::MAX_LANES];
+        uint256 hashes[RandomQKernel::MAX_LANES];
+        for (size_t i = 0; i < kernel.lanes; i++) {
+            nonces[i] = header.nNonce;
+        }
+        kernel.hash_lanes(job.midstate, nonces, hashes, kernel.lanes);
+        for (size_t i = 0; i < kernel.lanes; i++) {
+            ok &= ReportMismatch(name, std::string(kernel.name) + " lane " + std::to_string(i), hashes[i], reference);
+        }
+        
+        RandomQKernel::Activate(kernel);
+        uint256 range_hash;
+        uint64_t hits = 0;
+        RandomQMining::HashRange(job, header.nNonce, 1, any_hash, [&](uint32_t, const uint256& hash) {
+            range_hash = hash;
+            hits++;
+            return true;
+        });
+        if (hits != 1) {
+            std::cerr << "FAIL: " << name << ": HashRange " << kernel.name << " reported " << hits << " hits" << std::endl;
+            ok = false;
+        }
+        ok &= ReportMismatch(name, std::string("HashRange ") + kernel.name, range_hash, reference);
+    }
+    RandomQKernel::Activate(active);
+    
+    return ok;
+}
+
+} // namespace RandomQTest
+
+#endif // CPUMINER_TEST_RANDOMQ_TEST_UTIL_H
@@ -0,0 +1,70 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Checks that the per-hash mining path performs no heap allocations.
+
+#include "alloc_counter.h"
+#include "randomq_hash.h"
+#include "randomq_kernel.h"
+#include "randomq_mining.h"
+#include <iostream>
+
+namespace {
+
+const uint64_t TEST_ROUNDS = 64;
+const uint32_t TEST_HASHES = 256;
+
+bool CheckNoAllocations(const char* name, uint64_t before) {
+    uint64_t allocations = AllocCounter::Count() - before;
+    if (allocations != 0) {
+        std::cerr << "FAIL: " << name << " made " << allocations << " allocations" << std::endl;
+        return false;
+    }
+    std::cout << "ok: " << name << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.hashPrevBlock = uint256("0x0101010101010101010101010101010101010101010101010101010101010101");
+    header.hashMerkleRoot = uint256("0x0202020202020202020202020202020202020202020202020202020202020202");
+    header.nTime = 1234567890;
+    header.nBits = 0x1d00ffff;
+    
+    // Kernel selection and job setup may allocate; they run once per job
+    RandomQKernel::Select(true, true);
+    RandomQMining::HashJob job;
+    RandomQMining::PrepareJob(job, header, TEST_ROUNDS);
+    const uint256 target("0x00000000ffff0000000000000000000000000000000000000000000000000000");
+    const CompiledTarget compiled_target = CompiledTarget::FromTarget(target);
+    
+    // Mining loop: kernel lanes plus lane filter and target comparison
+    uint64_t below_target = 0;
+    uint64_t before = AllocCounter::Count();
+    RandomQMining::HashRange(job, 0, TEST_HASHES, compiled_target, [&](uint32_t, const uint256&) {
+        below_target++;
+        return true;
+    });
+    ok &= CheckNoAllocations("HashRange", before);
+    
+    // Fixed-size header API with a reused hasher
+    CRandomQHash hasher;
+    hasher.SetRandomQRounds(TEST_ROUNDS);
+    HeaderBytes header_data;
+    before = AllocCounter::Count();
+    for (uint32_t nonce = 0; nonce < TEST_HASHES; nonce++) {
+        header.nNonce = nonce;
+        RandomQMining::SerializeHeader(header, header_data);
+        below_target += RandomQMining::CheckTarget(RandomQMining::CalculateRandomQHash(hasher, header_data), target);
+    }
+    ok &= CheckNoAllocations("CalculateRandomQHash(hasher, span)", before);
+    
+    std::cout << below_target << " hashes below target" << std::endl;
+    return ok ? 0 : 1;
+}
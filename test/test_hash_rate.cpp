@@ -0,0 +1,104 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Hash rate meter test: window rates and the EWMA against rates computed
+// by hand, on synthetic timestamps.
+
+#include "hash_rate.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using Clock = HashRateMeter::Clock;
+
+bool CheckNear(const std::string& name, double got, double want) {
+    if (std::fabs(got - want) > 1e-6 * std::max(1.0, std::fabs(want))) {
+        std::cerr << "FAIL: " << name << ": got " << got << ", want " << want << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Feed rate hashes per second for seconds, one sample a second
+uint64_t Run(HashRateMeter& meter, Clock::time_point& now, uint64_t hashes, uint64_t rate, int seconds) {
+    for (int i = 0; i < seconds; i++) {
+        now += std::chrono::seconds(1);
+        hashes += rate;
+        meter.Sample(now, hashes);
+    }
+    return hashes;
+}
+
+bool CheckSteadyThenIdle() {
+    HashRateMeter meter;
+    Clock::time_point now{};
+    meter.Sample(now, 0);
+    uint64_t hashes = Run(meter, now, 0, 1000, 20 * 60);
+    bool ok = true;
+    HashRates rates = meter.Rates();
+    ok &= CheckNear("steady 10s", rates.rate_10s, 1000);
+    ok &= CheckNear("steady 60s", rates.rate_60s, 1000);
+    ok &= CheckNear("steady 15m", rates.rate_15m, 1000);
+    ok &= CheckNear("steady ewma", rates.ewma, 1000);
+    
+    // Thirty idle seconds: one EWMA time constant
+    Run(meter, now, hashes, 0, 30);
+    rates = meter.Rates();
+    ok &= CheckNear("idle 10s", rates.rate_10s, 0);
+    ok &= CheckNear("idle 60s", rates.rate_60s, 500);
+    ok &= CheckNear("idle 15m", rates.rate_15m, 1000.0 * 870 / 900);
+    ok &= CheckNear("idle ewma", rates.ewma, 1000 * std::exp(-1.0));
+    return ok;
+}
+
+bool CheckIrregularSamples() {
+    // 500 H/s sampled at uneven times; the window start falls between samples
+    HashRateMeter meter;
+    Clock::time_point start{};
+    for (int second : {0, 7, 13, 30}) {
+        meter.Sample(start + std::chrono::seconds(second), 500 * second);
+    }
+    bool ok = true;
+    ok &= CheckNear("irregular 10s", meter.Rate(std::chrono::seconds(10)), 500);
+    ok &= CheckNear("irregular 20s", meter.Rate(std::chrono::seconds(20)), 500);
+    
+    // Windows longer than the history cover the history
+    ok &= CheckNear("irregular 60s", meter.Rate(std::chrono::seconds(60)), 500);
+    return ok;
+}
+
+bool CheckReset() {
+    HashRateMeter meter;
+    Clock::time_point now{};
+    meter.Sample(now, 5000);
+    Run(meter, now, 5000, 100, 5);
+    
+    // A lower counter is a restarted thread, not negative work
+    now += std::chrono::seconds(1);
+    meter.Sample(now, 10);
+    bool ok = true;
+    ok &= CheckNear("reset 10s", meter.Rate(std::chrono::seconds(10)), 0);
+    ok &= CheckNear("reset ewma", meter.Ewma(), 0);
+    Run(meter, now, 10, 300, 2);
+    ok &= CheckNear("after reset 10s", meter.Rate(std::chrono::seconds(10)), 300);
+    ok &= CheckNear("after reset ewma", meter.Ewma(), 300);
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= CheckSteadyThenIdle();
+    ok &= CheckIrregularSamples();
+    ok &= CheckReset();
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "OK: hash rate windows and EWMA match" << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Checks that the mining threads stop allocating once warmed up: the real
+// thread loop runs lease after lease on benchmark work while the process-wide
+// allocation count stays flat.
+
+#include "alloc_counter.h"
+#include "randomq_miner.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const uint64_t ROUNDS = 64;
+const int THREADS = 2;
+const uint32_t NONCE_BATCH = 256;
+
+// Sampled reference checks run several times inside the measured window
+const uint64_t VERIFY_SAMPLE = 4096;
+
+// Leases, counters, the sampler's first samples and the lease size settle here
+const std::chrono::seconds WARM_UP(1);
+
+// Shorter than the 32 one-second samples that fill a chunk of the sampler's
+// deque, so every allocation in the window comes from the mining threads
+const std::chrono::seconds MEASURE(2);
+
+// Same shape as the --benchmark work: the all-zero target is never met and
+// the full nonce range never runs out, so no candidate or rolled job is made
+WorkData MakeBenchmarkWork() {
+    WorkData work;
+    work.block_template = "benchmark";
+    work.previous_block_hash = "000000000000000000000000000000000000000000000000000000000000b0b0";
+    work.merkle_root = "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b";
+    work.target = "0000000000000000000000000000000000000000000000000000000000000000";
+    work.version = 0x20000000;
+    work.timestamp = 1700000000;
+    work.bits = 0x1d00ffff;
+    work.height = 1;
+    work.nonce_start = 0;
+    work.nonce_end = 0xFFFFFFFF;
+    return work;
+}
+
+} // namespace
+
+int main() {
+    RandomQMiner miner;
+    miner.setThreadCount(THREADS);
+    miner.setRandomQRounds(ROUNDS);
+    miner.setNonceBatch(NONCE_BATCH);
+    miner.setVerifySample(VERIFY_SAMPLE);
+    miner.setAffinity("none");
+    miner.setWork(MakeBenchmarkWork());
+    miner.start();
+    std::this_thread::sleep_for(WARM_UP);
+    
+    // This thread only sleeps between the two counts
+    uint64_t hashes_before = miner.getStats().total_hashes;
+    uint64_t before = AllocCounter::Count();
+    std::this_thread::sleep_for(MEASURE);
+    uint64_t allocations = AllocCounter::Count() - before;
+    uint64_t hashes = miner.getStats().total_hashes - hashes_before;
+    miner.stop();
+    
+    bool ok = true;
+    if (hashes < 4 * THREADS * NONCE_BATCH) {
+        std::cerr << "FAIL: only " << hashes << " hashes in the measured window, too few leases to check" << std::endl;
+        ok = false;
+    }
+    if (allocations != 0) {
+        std::cerr << "FAIL: mining threads made " << allocations << " allocations over " << hashes << " hashes" << std::endl;
+        ok = false;
+    }
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "ok: " << hashes << " hashes with no allocations after warm-up" << std::endl;
+    return 0;
+}
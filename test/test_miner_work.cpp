@@ -0,0 +1,204 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Work acceptance test: work that carries only nBits, with no target
+// string, must pass WorkData::isValid(), be published by setWork() and
+// yield blocks checked against the compact target. nBits that consensus
+// rejects (negative, overflowing or zero) must not decode to a target.
+// Header rolling must stop at the time limit and at what the template permits.
+
+#include "randomq_miner.h"
+#include "randomq_mining.h"
+#include "randomq_target.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const uint64_t ROUNDS = 8;
+
+// Easiest compact target: almost every hash meets it
+const uint32_t EASY_BITS = 0x2100ffff;
+
+WorkData MakeWork() {
+    WorkData work;
+    work.block_template = "00";
+    work.previous_block_hash = "00";
+    work.merkle_root = "11";
+    work.version = 0x20000000;
+    work.timestamp = 1700000000;
+    work.bits = EASY_BITS;
+    work.height = 1;
+    work.nonce_start = 0;
+    work.nonce_end = 0xffff;
+    return work;
+}
+
+bool CheckValidity() {
+    bool ok = true;
+    WorkData work = MakeWork();
+    if (!work.isValid()) {
+        std::cerr << "FAIL: nBits-only work rejected by isValid()" << std::endl;
+        ok = false;
+    }
+    work.target = "00ffff0000000000000000000000000000000000000000000000000000000000";
+    work.bits = 0;
+    if (!work.isValid()) {
+        std::cerr << "FAIL: target-only work rejected by isValid()" << std::endl;
+        ok = false;
+    }
+    work.target.clear();
+    if (work.isValid()) {
+        std::cerr << "FAIL: work with neither target nor nBits accepted" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+bool CheckCompactBits() {
+    struct Case {
+        uint32_t bits;
+        bool valid;
+    };
+    const Case cases[] = {
+        {0x1d00ffff, true},
+        {EASY_BITS, true},
+        {0x207fffff, true},
+        {0x04923456, false}, // Sign bit set
+        {0x01fedcba, false}, // Sign bit set
+        {0x01003456, false}, // Mantissa shifted out: zero target
+        {0x00000000, false},
+        {0x23000001, false}, // Mantissa past bit 255
+        {0x2200ff00, false},
+        {0xff123456, false},
+    };
+    bool ok = true;
+    for (const Case& c : cases) {
+        CompiledTarget target;
+        if (CompiledTarget::FromCompact(c.bits, target) != c.valid) {
+            std::cerr << "FAIL: nBits 0x" << std::hex << c.bits << std::dec << (c.valid ? " rejected" : " accepted") << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool CheckRollHeader() {
+    bool ok = true;
+    auto expect = [&](const char* step, bool rolled, uint32_t version, uint32_t time,
+                      bool want_rolled, uint32_t want_version, uint32_t want_time) {
+        if (rolled != want_rolled || version != want_version || time != want_time) {
+            std::cerr << "FAIL: RollHeader " << step << ": got " << rolled << " 0x" << std::hex << version << std::dec
+                      << " " << time << ", want " << want_rolled << " 0x" << std::hex << want_version << std::dec
+                      << " " << want_time << std::endl;
+            ok = false;
+        }
+    };
+    
+    // Two mask bits starting from a base with one of them set: three more
+    // combinations, then the wrap back to the base steps nTime
+    const uint32_t mask = 0x00006000;
+    const uint32_t base = 0x20002000;
+    uint32_t version = base;
+    uint32_t time = 100;
+    const uint32_t versions[] = {0x20004000, 0x20006000, 0x20000000};
+    for (uint32_t want : versions) {
+        bool rolled = RandomQMining::RollHeader(version, time, base, mask, 101);
+        expect("version step", rolled, version, time, true, want, 100);
+    }
+    bool rolled = RandomQMining::RollHeader(version, time, base, mask, 101);
+    expect("wrap", rolled, version, time, true, base, 101);
+    
+    // The next wrap finds nTime at the limit
+    for (uint32_t want : versions) {
+        rolled = RandomQMining::RollHeader(version, time, base, mask, 101);
+        expect("version step at limit", rolled, version, time, true, want, 101);
+    }
+    rolled = RandomQMining::RollHeader(version, time, base, mask, 101);
+    expect("time limit", rolled, version, time, false, base, 101);
+    
+    // Without version bits, only nTime rolls
+    version = base;
+    time = 100;
+    rolled = RandomQMining::RollHeader(version, time, base, 0, 101);
+    expect("time only", rolled, version, time, true, base, 101);
+    rolled = RandomQMining::RollHeader(version, time, base, 0, 101);
+    expect("time only at limit", rolled, version, time, false, base, 101);
+    return ok;
+}
+
+// A template that permits no rolling is hashed once, then new work is requested
+bool CheckNoRollingWithoutPermission() {
+    WorkData work = MakeWork();
+    work.target = "0000000000000000000000000000000000000000000000000000000000000000";
+    work.nonce_end = 0xff;
+    
+    RandomQMiner miner;
+    std::atomic<bool> requested{false};
+    miner.setThreadCount(1);
+    miner.setRandomQRounds(ROUNDS);
+    miner.setWorkRequest([&] { requested = true; });
+    miner.setWork(work);
+    miner.start();
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!requested && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    miner.stop();
+    
+    uint64_t hashes = miner.getStats().total_hashes;
+    if (!requested || hashes != static_cast<uint64_t>(work.nonce_end) + 1) {
+        std::cerr << "FAIL: work without rolling permission: " << hashes << " hashes, "
+                  << (requested ? "" : "no ") << "work request" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CheckMining() {
+    RandomQMiner miner;
+    miner.setThreadCount(1);
+    miner.setRandomQRounds(ROUNDS);
+    miner.setWork(MakeWork());
+    miner.start();
+    
+    // Blocks are verified on the submitter thread; wait for the first one
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (miner.getStats().valid_blocks == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    miner.stop();
+    
+    MiningStats stats = miner.getStats();
+    bool ok = true;
+    if (stats.valid_blocks == 0) {
+        std::cerr << "FAIL: no block found on nBits-only work (" << stats.total_hashes << " hashes)" << std::endl;
+        ok = false;
+    }
+    if (stats.invalid_blocks != 0 || stats.kernel_faults != 0) {
+        std::cerr << "FAIL: " << stats.invalid_blocks << " candidates failed nBits, "
+                  << stats.kernel_faults << " kernel faults" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= CheckValidity();
+    ok &= CheckCompactBits();
+    ok &= CheckRollHeader();
+    ok &= CheckNoRollingWithoutPermission();
+    ok &= CheckMining();
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "OK: nBits-only work is accepted and mined" << std::endl;
+    return 0;
+}
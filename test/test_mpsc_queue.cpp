@@ -0,0 +1,99 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Solution queue test: every value pushed by concurrent producers is popped
+// exactly once, in order per producer, and a full queue rejects pushes.
+
+#include "mpsc_queue.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t PRODUCERS = 4;
+const uint64_t PER_PRODUCER = 200000;
+
+bool CheckBounds() {
+    bool ok = true;
+    MpscQueue<uint64_t> queue(5);
+    if (queue.Capacity() != 8) {
+        std::cerr << "FAIL: capacity 5 rounded to " << queue.Capacity() << std::endl;
+        ok = false;
+    }
+    
+    // Several laps around the ring, filling it each time
+    for (uint64_t lap = 0; lap < 3; lap++) {
+        for (uint64_t i = 0; i < queue.Capacity(); i++) {
+            ok &= queue.TryPush(lap * 100 + i);
+        }
+        if (queue.TryPush(999)) {
+            std::cerr << "FAIL: push into a full queue succeeded" << std::endl;
+            ok = false;
+        }
+        for (uint64_t i = 0; i < queue.Capacity(); i++) {
+            uint64_t value = 0;
+            if (!queue.TryPop(value) || value != lap * 100 + i) {
+                std::cerr << "FAIL: lap " << lap << " popped " << value << ", expected " << lap * 100 + i << std::endl;
+                ok = false;
+            }
+        }
+        uint64_t value = 0;
+        if (queue.TryPop(value)) {
+            std::cerr << "FAIL: pop from an empty queue succeeded" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool CheckConcurrent() {
+    // Small enough that producers regularly find the queue full and retry
+    MpscQueue<uint64_t> queue(64);
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; i++) {
+                while (!queue.TryPush((p << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    bool ok = true;
+    uint64_t popped = 0;
+    while (popped < PRODUCERS * PER_PRODUCER) {
+        uint64_t value = 0;
+        if (!queue.TryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint64_t p = value >> 32, i = value & 0xffffffff;
+        if (p >= PRODUCERS || i != next[p]) {
+            std::cerr << "FAIL: producer " << p << " value " << i << " out of order" << std::endl;
+            ok = false;
+            break;
+        }
+        next[p]++;
+        popped++;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = CheckBounds();
+    ok &= CheckConcurrent();
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "OK: " << PRODUCERS * PER_PRODUCER << " values through the queue from " << PRODUCERS << " producers" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Randomized differential test: every compiled kernel, the midstate path
+// and HashRange must match the reference CRandomQ path bit for bit.
+//
+// Usage: test_randomq_diff [seed]
+
+#include "randomq_test_util.h"
+#include <iterator>
+#include <random>
+
+namespace {
+
+const uint64_t DEFAULT_SEED = 0x52616e646f6d51ULL;
+const int ITERATIONS = 64;
+const uint64_t ROUND_CHOICES[] = {1, 2, 3, 7, 64, 257};
+const int FILTER_ITERATIONS = 4096;
+
+void RandomBytes(std::mt19937_64& rng, unsigned char* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        out[i] = static_cast<unsigned char>(rng());
+    }
+}
+
+uint256 ReferenceHashForNonce(const CBlockHeader& header, uint32_t nonce, uint64_t rounds) {
+    CBlockHeader copy = header;
+    copy.nNonce = nonce;
+    HeaderBytes data;
+    RandomQMining::SerializeHeader(copy, data);
+    return RandomQTest::ReferenceHash(data, rounds);
+}
+
+// Distinct nonces in every lane, so a kernel mixing up lanes fails
+bool CheckDistinctLanes(std::mt19937_64& rng, const std::string& name, const CBlockHeader& header, uint64_t rounds) {
+    bool ok = true;
+    RandomQMining::HashJob job;
+    RandomQMining::PrepareJob(job, header, rounds);
+    
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        // Partial batches use fewer lanes than the kernel width
+        for (size_t lanes = 1; lanes <= kernel.lanes; lanes++) {
+            uint32_t nonces[RandomQKernel::MAX_LANES];
+            uint256 hashes[RandomQKernel::MAX_LANES];
+            for (size_t i = 0; i < lanes; i++) {
+                nonces[i] = static_cast<uint32_t>(rng());
+            }
+            kernel.hash_lanes(job.midstate, nonces, hashes, lanes);
+            for (size_t i = 0; i < lanes; i++) {
+                ok &= RandomQTest::ReportMismatch(name, std::string(kernel.name) + " " + std::to_string(lanes) +
+                                                  " lanes, lane " + std::to_string(i),
+                                                  hashes[i], ReferenceHashForNonce(header, nonces[i], rounds));
+            }
+        }
+    }
+    return ok;
+}
+
+// HashRange across the 32-bit nonce wrap, with an early stop
+bool CheckHashRange(const CBlockHeader& header, uint64_t rounds) {
+    bool ok = true;
+    RandomQMining::HashJob job;
+    RandomQMining::PrepareJob(job, header, rounds);
+    const CompiledTarget any_hash = CompiledTarget::FromTarget(uint256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));
+    const uint32_t begin = 0xfffffffb;
+    const uint64_t count = 2 * RandomQKernel::MAX_LANES + 3;
+    
+    const RandomQKernel::Kernel& active = RandomQKernel::Active();
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        RandomQKernel::Activate(kernel);
+        const std::string name = std::string("HashRange ") + kernel.name;
+        
+        uint32_t expected_nonce = begin;
+        uint64_t hits = 0;
+        uint64_t done = RandomQMining::HashRange(job, begin, count, any_hash, [&](uint32_t nonce, const uint256& hash) {
+            if (nonce != expected_nonce) {
+                std::cerr << "FAIL: " << name << ": nonce " << nonce << ", expected " << expected_nonce << std::endl;
+                ok = false;
+            }
+            ok &= RandomQTest::ReportMismatch(name, "nonce " + std::to_string(nonce), hash, ReferenceHashForNonce(header, nonce, rounds));
+            expected_nonce++;
+            hits++;
+            return true;
+        });
+        if (done != count || hits != count) {
+            std::cerr << "FAIL: " << name << ": hashed " << done << " with " << hits << " hits, expected " << count << std::endl;
+            ok = false;
+        }
+        
+        // Stopping on the third hit still counts the rest of that batch as hashed
+        hits = 0;
+        done = RandomQMining::HashRange(job, begin, count, any_hash, [&](uint32_t, const uint256&) {
+            return ++hits < 3;
+        });
+        if (hits != 3 || done < 3 || done > 2 + kernel.lanes) {
+            std::cerr << "FAIL: " << name << ": early stop after " << hits << " hits, " << done << " hashed" << std::endl;
+            ok = false;
+        }
+        
+        // should_stop() is polled before every kernel call
+        int polls = 0;
+        done = RandomQMining::HashRange(job, begin, count, any_hash, [](uint32_t, const uint256&) { return true; },
+                                        [&] { return ++polls > 2; });
+        if (done != 2 * kernel.lanes) {
+            std::cerr << "FAIL: " << name << ": stopped after " << done << " hashes, expected " << 2 * kernel.lanes << std::endl;
+            ok = false;
+        }
+    }
+    RandomQKernel::Activate(active);
+    return ok;
+}
+
+// Vector lane filters must agree with the scalar top-word compare
+bool CheckFilters(std::mt19937_64& rng) {
+    bool ok = true;
+    for (int iter = 0; iter < FILTER_ITERATIONS; iter++) {
+        uint256 hashes[RandomQKernel::MAX_LANES];
+        for (size_t i = 0; i < RandomQKernel::MAX_LANES; i++) {
+            RandomBytes(rng, hashes[i].begin(), 32);
+        }
+        // Use one lane's top word as the target so the equal case is covered
+        uint64_t target_top = CompiledTarget::TopWord(hashes[rng() % RandomQKernel::MAX_LANES]);
+        if (iter % 2) {
+            target_top += static_cast<int64_t>(rng() % 5) - 2;
+        }
+        
+        for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+            if (!RandomQKernel::IsSupported(kernel)) {
+                continue;
+            }
+            for (size_t lanes = 1; lanes <= kernel.lanes; lanes++) {
+                uint32_t expected = 0;
+                for (size_t i = 0; i < lanes; i++) {
+                    expected |= static_cast<uint32_t>(CompiledTarget::TopWord(hashes[i]) <= target_top) << i;
+                }
+                uint32_t mask = kernel.filter_lanes(hashes, lanes, target_top);
+                if (mask != expected) {
+                    std::cerr << "FAIL: " << kernel.name << " filter, " << lanes << " lanes: mask " << mask
+                              << ", expected " << expected << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+// Disabled kernels drop out of Select(); the generic fallback cannot be disabled
+bool CheckDisable() {
+    bool ok = true;
+    const RandomQKernel::Kernel& generic = RandomQKernel::GetKernels().front();
+    if (RandomQKernel::Disable(generic) || RandomQKernel::IsDisabled(generic)) {
+        std::cerr << "FAIL: generic kernel was disabled" << std::endl;
+        ok = false;
+    }
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (kernel.isa == RandomQKernel::Isa::GENERIC || !RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        if (!RandomQKernel::Disable(kernel) || RandomQKernel::Disable(kernel) || !RandomQKernel::IsDisabled(kernel)) {
+            std::cerr << "FAIL: Disable(" << kernel.name << ") must succeed exactly once" << std::endl;
+            ok = false;
+        }
+    }
+    const RandomQKernel::Kernel& selected = RandomQKernel::Select(true, true);
+    if (selected.isa != RandomQKernel::Isa::GENERIC) {
+        std::cerr << "FAIL: Select() returned disabled kernel " << selected.name << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint64_t seed = argc > 1 ? std::stoull(argv[1], nullptr, 0) : DEFAULT_SEED;
+    std::mt19937_64 rng(seed);
+    std::cout << "Seed: " << seed << std::endl;
+    
+    RandomQKernel::Select(true, true);
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        std::cout << "Kernel " << kernel.name << ": "
+                  << (RandomQKernel::IsSupported(kernel) ? "tested" : "not supported by this CPU") << std::endl;
+    }
+    
+    bool ok = true;
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        HeaderBytes data;
+        RandomBytes(rng, data.data(), data.size());
+        // One iteration at the default rounds covers the fixed-round convenience paths
+        uint64_t rounds = iter == 0 ? 8192 : ROUND_CHOICES[rng() % std::size(ROUND_CHOICES)];
+        const std::string name = "iteration " + std::to_string(iter) + " (rounds " + std::to_string(rounds) + ")";
+        
+        ok &= RandomQTest::CheckAllPaths(name, data, rounds, RandomQTest::ReferenceHash(data, rounds));
+        ok &= CheckDistinctLanes(rng, name, RandomQTest::HeaderFromBytes(data), rounds);
+    }
+    
+    CBlockHeader header = RandomQTest::HeaderFromBytes(HeaderBytes{});
+    ok &= CheckHashRange(header, 64);
+    ok &= CheckFilters(rng);
+    ok &= CheckDisable(); // Last: leaves only the generic kernel selectable
+    
+    std::cout << (ok ? "All kernels match the reference path" : "Kernel mismatch") << std::endl;
+    return ok ? 0 : 1;
+}
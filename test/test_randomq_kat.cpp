@@ -0,0 +1,118 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Known-answer test: hashes every vector in the KAT file through the
+// reference CRandomQ path and every cpuminer path.
+//
+// Usage: test_randomq_kat <vector file>
+//        test_randomq_kat --regenerate <vector file>
+//
+// A vector without a recorded expected hash fails the test.
+
+#include "randomq_test_util.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct KatVector {
+    size_t line;
+    HeaderBytes header;
+    uint64_t rounds;
+    std::string expected; // "-" if not recorded
+};
+
+bool LoadVectors(const std::string& path, std::vector<std::string>& lines, std::vector<KatVector>& vectors) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        
+        std::istringstream fields(line);
+        std::string header_hex;
+        KatVector vector;
+        vector.line = lines.size();
+        if (!(fields >> header_hex >> vector.rounds >> vector.expected) ||
+            !RandomQTest::ParseHex(header_hex, vector.header) || vector.rounds == 0) {
+            std::cerr << path << ":" << vector.line << ": malformed vector" << std::endl;
+            return false;
+        }
+        vectors.push_back(vector);
+    }
+    return true;
+}
+
+// Rewrite the file with reference hashes, keeping comments and layout
+bool Regenerate(const std::string& path, std::vector<std::string>& lines, const std::vector<KatVector>& vectors) {
+    for (const KatVector& vector : vectors) {
+        uint256 hash = RandomQTest::ReferenceHash(vector.header, vector.rounds);
+        lines[vector.line - 1] = RandomQTest::ToHex(vector.header) + " " + std::to_string(vector.rounds) + " " + hash.ToString();
+    }
+    
+    std::ofstream file(path, std::ios::trunc);
+    for (const std::string& line : lines) {
+        file << line << "\n";
+    }
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+    std::cout << "Recorded " << vectors.size() << " vectors in " << path << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool regenerate = argc == 3 && std::string(argv[1]) == "--regenerate";
+    if (argc != 2 && !regenerate) {
+        std::cerr << "Usage: " << argv[0] << " [--regenerate] <vector file>" << std::endl;
+        return 2;
+    }
+    const std::string path = argv[argc - 1];
+    
+    std::vector<std::string> lines;
+    std::vector<KatVector> vectors;
+    if (!LoadVectors(path, lines, vectors)) {
+        return 1;
+    }
+    if (vectors.empty()) {
+        std::cerr << path << ": no vectors" << std::endl;
+        return 1;
+    }
+    if (regenerate) {
+        return Regenerate(path, lines, vectors) ? 0 : 1;
+    }
+    
+    RandomQKernel::Select(true, true);
+    
+    bool ok = true;
+    for (const KatVector& vector : vectors) {
+        const std::string name = path + ":" + std::to_string(vector.line);
+        const uint256 reference = RandomQTest::ReferenceHash(vector.header, vector.rounds);
+        
+        if (vector.expected == "-") {
+            std::cerr << "FAIL: " << name << ": no expected hash recorded" << std::endl;
+            ok = false;
+        } else if (reference.ToString() != vector.expected) {
+            std::cerr << "FAIL: " << name << ": reference hash " << reference.ToString()
+                      << ", expected " << vector.expected << std::endl;
+            ok = false;
+        }
+        
+        ok &= RandomQTest::CheckAllPaths(name, vector.header, vector.rounds, reference);
+    }
+    
+    std::cout << vectors.size() << " vectors checked against the reference path" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Batch verifier test: the pass/fail bitmap from RandomQVerify must match
+// a per-header reference check, for every kernel and thread count.
+
+#include "randomq_test_util.h"
+#include "randomq_verify.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint64_t ROUNDS = 7;
+const size_t HEADER_COUNT = 77;
+
+// Reference check with the CheckRandomQProofOfWork target rules
+bool ReferencePasses(std::span<const unsigned char, CRandomQHash::HEADER_SIZE> data, const uint256& pow_limit) {
+    uint256 target = uint256().SetCompact(RandomQTest::ReadLE32(data.data() + 72));
+    if (target == uint256() || target > pow_limit) {
+        return false;
+    }
+    return RandomQMining::CheckTarget(RandomQTest::ReferenceHash(data, ROUNDS), target);
+}
+
+// Mix of same-prefix runs of varying length, single headers, and easy,
+// impossible and invalid nBits
+std::vector<unsigned char> MakeHeaders(std::mt19937_64& rng) {
+    const uint32_t bits_choices[] = {0x207fffff, 0x2100ffff, 0x1d00ffff, 0x00000000, 0x04923456};
+    std::vector<unsigned char> headers(HEADER_COUNT * RandomQVerify::HEADER_SIZE);
+    size_t i = 0;
+    while (i < HEADER_COUNT) {
+        unsigned char prefix[CRandomQHash::HEADER_PREFIX_SIZE];
+        for (unsigned char& c : prefix) {
+            c = static_cast<unsigned char>(rng());
+        }
+        uint32_t bits = bits_choices[rng() % std::size(bits_choices)];
+        for (int b = 0; b < 4; b++) {
+            prefix[72 + b] = static_cast<unsigned char>(bits >> (8 * b));
+        }
+        size_t run = std::min<size_t>(1 + rng() % 11, HEADER_COUNT - i);
+        for (size_t r = 0; r < run; r++, i++) {
+            unsigned char* header = headers.data() + i * RandomQVerify::HEADER_SIZE;
+            std::memcpy(header, prefix, sizeof(prefix));
+            for (int b = 0; b < 4; b++) {
+                header[CRandomQHash::HEADER_PREFIX_SIZE + b] = static_cast<unsigned char>(rng());
+            }
+        }
+    }
+    return headers;
+}
+
+bool CheckResult(const std::string& name, const std::vector<unsigned char>& headers, const RandomQVerify::Options& options) {
+    RandomQVerify::Result result = RandomQVerify::VerifyHeaders(headers, options);
+    bool ok = true;
+    if (result.count != HEADER_COUNT || result.bitmap.size() != (HEADER_COUNT + 7) / 8) {
+        std::cerr << "FAIL: " << name << ": counted " << result.count << " headers" << std::endl;
+        return false;
+    }
+    
+    size_t passed = 0;
+    for (size_t i = 0; i < HEADER_COUNT; i++) {
+        std::span<const unsigned char, CRandomQHash::HEADER_SIZE> data(headers.data() + i * RandomQVerify::HEADER_SIZE,
+                                                                       CRandomQHash::HEADER_SIZE);
+        bool want = ReferencePasses(data, options.pow_limit);
+        if (RandomQVerify::Passed(result, i) != want) {
+            std::cerr << "FAIL: " << name << ": header " << i << " "
+                      << (want ? "should pass" : "should fail") << std::endl;
+            ok = false;
+        }
+        passed += want;
+    }
+    if (result.passed != passed) {
+        std::cerr << "FAIL: " << name << ": passed " << result.passed << ", reference " << passed << std::endl;
+        ok = false;
+    }
+    
+    // Padding bits past the last header stay clear
+    if (result.bitmap.back() >> (HEADER_COUNT % 8) != 0) {
+        std::cerr << "FAIL: " << name << ": padding bits set" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng(0x566572696679ULL);
+    const std::vector<unsigned char> headers = MakeHeaders(rng);
+    bool ok = true;
+    
+    RandomQVerify::Options options;
+    options.rounds = ROUNDS;
+    
+    const RandomQKernel::Kernel& active = RandomQKernel::Active();
+    for (const RandomQKernel::Kernel& kernel : RandomQKernel::GetKernels()) {
+        if (!RandomQKernel::IsSupported(kernel)) {
+            continue;
+        }
+        RandomQKernel::Activate(kernel);
+        for (unsigned int threads : {1u, 3u, 16u}) {
+            options.threads = threads;
+            ok &= CheckResult(std::string(kernel.name) + " " + std::to_string(threads) + " threads", headers, options);
+        }
+    }
+    RandomQKernel::Activate(active);
+    
+    // A lower pow limit rejects the easiest targets
+    options.threads = 2;
+    options.pow_limit = uint256("0x00000000ffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+    ok &= CheckResult("pow limit", headers, options);
+    
+    // Trailing bytes short of a full header are ignored
+    std::vector<unsigned char> empty(RandomQVerify::HEADER_SIZE - 1);
+    if (RandomQVerify::VerifyHeaders(empty, options).count != 0) {
+        std::cerr << "FAIL: partial header counted" << std::endl;
+        ok = false;
+    }
+    
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "OK: batch verifier matches the reference on " << HEADER_COUNT << " headers" << std::endl;
+    return 0;
+}
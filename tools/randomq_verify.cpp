@@ -0,0 +1,197 @@
+// Copyright (c) 2024-present The Bitquantum Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// randomq-verify: checks a file or stream of serialized 80-byte block
+// headers against their own nBits and writes a pass/fail bitmap.
+//
+// Usage: randomq-verify [--threads N] [--rounds N] [--pow-limit HEX] [--bitmap FILE] [FILE|-]
+
+#include "cpu_info.h"
+#include "randomq_kernel.h"
+#include "randomq_verify.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VERIFY_HAVE_MMAP 1
+#endif
+
+namespace {
+
+// Most worker threads --threads may ask for, per usable CPU
+const uint64_t MAX_THREADS_PER_CPU = 4;
+
+// Parse a decimal count in [min, max]; false on anything else, including
+// signs, trailing characters and out-of-range values strtoull would wrap
+bool ParseCount(const char* text, uint64_t min, uint64_t max, uint64_t& out) {
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (errno != 0 || *end != '\0' || value < min || value > max) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+// Header bytes, memory-mapped from a file where possible
+class HeaderInput {
+public:
+    ~HeaderInput() {
+#if defined(VERIFY_HAVE_MMAP)
+        if (m_mapped) {
+            munmap(m_mapped, m_mapped_size);
+        }
+#endif
+    }
+    
+    bool open(const std::string& path) {
+        if (path == "-") {
+            m_buffer.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+            m_data = reinterpret_cast<const unsigned char*>(m_buffer.data());
+            m_size = m_buffer.size();
+            return true;
+        }
+#if defined(VERIFY_HAVE_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+                    m_mapped = mapped;
+                    m_mapped_size = st.st_size;
+                    m_data = static_cast<const unsigned char*>(mapped);
+                    m_size = st.st_size;
+                }
+            }
+            ::close(fd);
+            if (m_data) {
+                return true;
+            }
+        }
+#endif
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = reinterpret_cast<const unsigned char*>(m_buffer.data());
+        m_size = m_buffer.size();
+        return true;
+    }
+    
+    std::span<const unsigned char> bytes() const { return {m_data, m_size}; }
+
+private:
+    std::vector<char> m_buffer;
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(VERIFY_HAVE_MMAP)
+    void* m_mapped = nullptr;
+    size_t m_mapped_size = 0;
+#endif
+};
+
+void PrintUsage(const char* name) {
+    std::cerr << "Usage: " << name << " [options] [FILE|-]" << std::endl;
+    std::cerr << "Verify serialized 80-byte block headers against their nBits targets." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --threads <count>    Worker threads, at most 4 per usable CPU (default: all usable CPUs)" << std::endl;
+    std::cerr << "  --rounds <num>       RandomQ rounds (default: 8192)" << std::endl;
+    std::cerr << "  --pow-limit <hex>    Reject targets above this limit (default: none)" << std::endl;
+    std::cerr << "  --bitmap <file>      Write the raw pass/fail bitmap to a file instead of hex to stdout" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    RandomQVerify::Options options;
+    std::string input_path = "-";
+    std::string bitmap_path;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            uint64_t max_threads = CPUInfo::UsableCpuCount() * MAX_THREADS_PER_CPU;
+            uint64_t threads = 0;
+            if (!ParseCount(argv[++i], 1, max_threads, threads)) {
+                std::cerr << "Error: --threads must be a number from 1 to " << max_threads << std::endl;
+                return 2;
+            }
+            options.threads = static_cast<unsigned int>(threads);
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            if (!ParseCount(argv[++i], 1, UINT64_MAX, options.rounds)) {
+                std::cerr << "Error: RandomQ rounds must be a number greater than 0" << std::endl;
+                return 2;
+            }
+        } else if (arg == "--pow-limit" && i + 1 < argc) {
+            options.pow_limit = uint256(argv[++i]);
+        } else if (arg == "--bitmap" && i + 1 < argc) {
+            bitmap_path = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (arg.size() > 1 && arg[0] == '-' && arg != "-") {
+            PrintUsage(argv[0]);
+            return 2;
+        } else {
+            input_path = arg;
+        }
+    }
+    HeaderInput input;
+    if (!input.open(input_path)) {
+        std::cerr << "Error: Cannot open " << input_path << std::endl;
+        return 2;
+    }
+    if (input.bytes().size() % RandomQVerify::HEADER_SIZE != 0) {
+        std::cerr << "Warning: ignoring " << input.bytes().size() % RandomQVerify::HEADER_SIZE
+                  << " trailing bytes" << std::endl;
+    }
+    
+    const RandomQKernel::Kernel& kernel = RandomQKernel::Select(true, true);
+    
+    auto start = std::chrono::steady_clock::now();
+    RandomQVerify::Result result = RandomQVerify::VerifyHeaders(input.bytes(), options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (!bitmap_path.empty()) {
+        std::ofstream out(bitmap_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(result.bitmap.data()), result.bitmap.size());
+        if (!out) {
+            std::cerr << "Error: Cannot write " << bitmap_path << std::endl;
+            return 2;
+        }
+    } else {
+        std::cout << std::hex << std::setfill('0');
+        for (uint8_t byte : result.bitmap) {
+            std::cout << std::setw(2) << static_cast<int>(byte);
+        }
+        std::cout << std::dec << std::endl;
+    }
+    
+    std::cerr << "Headers: " << result.count << ", passed: " << result.passed
+              << ", failed: " << result.count - result.passed << std::endl;
+    std::cerr << "Kernel: " << kernel.name << ", " << std::fixed << std::setprecision(3) << seconds << " s, "
+              << std::setprecision(1) << (seconds > 0 ? result.count / seconds : 0.0) << " headers/s" << std::endl;
+    
+    return result.passed == result.count ? 0 : 1;
+}